@@ -14,620 +14,8504 @@
 #include <mutex>              // mutex, unique_lock
 #include <condition_variable> // condition_variable
 #include <queue>              // queue used in async queue
+#include <deque>              // deque used in thread pool
+#include <functional>         // function
+#include <exception>          // exception_ptr
+#if defined(__linux__)
+#include <linux/futex.h>      // futex used by lock free queue wait strategy
+#include <sys/syscall.h>      // syscall
+#include <climits>
+#include <pthread.h>          // pthread_setaffinity_np
+#include <linux/mempolicy.h>  // MPOL_PREFERRED of NUMA local frames
+#endif
+#include <unistd.h>           // close, dup, sysconf
+#include <cstdlib>            // realpath of config files
+#include <fcntl.h>            // open, posix_fadvise of raw frames readers
+#include <sys/mman.h>         // mmap, madvise of raw frames files
+#include <sys/stat.h>         // fstat
+#include <cstdio>             // stdio streams of raw frames
+#include <cerrno>             // errno of raw frames readers
+#include <csignal>            // pthread_sigmask, sigwait of shutdown signals
 #include <random>             // to generate random values
 #include <memory>             // shared pointers
+#include <array>              // fixed size arrays
+#include <map>                // map used in registries
+#include <utility>            // pair, index_sequence
+#include <stdexcept>          // invalid_argument
+#include <atomic>             // atomic
+#include <sstream>            // ostringstream used to format log messages
+#include <chrono>             // steady clock, durations
+#include <new>                // aligned operator new
+#include <cstring>            // memset, memcpy
+#include <cmath>              // lround, trigonometry of synthetic motion
+#include <fstream>            // ofstream of benchmark JSON report, ifstream of config file
+#include <iomanip>            // setw, setprecision of benchmark table
+#include <type_traits>        // is_base_of
+#include <initializer_list>   // initializer_list of option names
 
 using namespace std;
 
+using FrameClock = chrono::steady_clock; /**< monotonic clock used for frame timestamps and scheduling. */
+
 /**
- * @brief VideoFrame class to store pixels and video Frame size (width && height).
+ * @brief log levels, each level includes all previous ones.
  */
-class VideoFrame
+enum class LogLevel : int
+{
+    Quiet = 0, /**< nothing is logged. */
+    Info = 1,  /**< pipeline events (found patterns, ...). */
+    Debug = 2, /**< per frame tracing (frame generation, frame constructor/destructor, ...). */
+    Trace = 3  /**< per pixel tracing (dump of generated pixels). */
+};
+
+/**
+ * @brief max log level compiled in : any log of higher level is removed at compile time.
+ * default keeps all levels, can be set through cmake cache variable MOTIONDETECTOR_MAX_LOG_LEVEL.
+ */
+#ifndef MOTIONDETECTOR_MAX_LOG_LEVEL
+#define MOTIONDETECTOR_MAX_LOG_LEVEL 3
+#endif
+
+/**
+ * @brief process wide logger : runtime level filtering on top of compile time level.
+ * messages are formatted first and then written to stdout with one write without flush.
+ */
+class Logger
 {
 public:
     /**
-     * @brief video frame class constructor.
-     * @param width(in): video frame width.
-     * @param height(in): video frame Height.
+     * @brief sets runtime log level.
+     * @param level(in): new log level.
+     */
+    static void setLevel(LogLevel level)
+    {
+        runtimeLevel().store(static_cast<int>(level), memory_order_relaxed);
+    }
+
+    /**
+     * @brief checks if a log level is enabled (compiled in and allowed at runtime).
+     * @param level(in): log level to check.
+     * @return bool: true if messages of this level must be written.
      */
-    VideoFrame(uint8_t &width, uint8_t &height, vector<vector<uint8_t>> &pixels) :
-            m_width(width), m_height(height), m_pixels(pixels)
+    static bool isEnabled(LogLevel level)
     {
-        cout << "VideoFrame constructor called : " << this << endl;
+        return (static_cast<int>(level) <= MOTIONDETECTOR_MAX_LOG_LEVEL) &&
+               (static_cast<int>(level) <= runtimeLevel().load(memory_order_relaxed));
     }
+
     /**
-     * @brief video frame class destructor.
+     * @brief writes message in stdout.
+     * @param message(in): formatted message.
      */
-    ~VideoFrame()
+    static void write(const string &message)
+    {
+        cout.write(message.data(), message.size());
+    }
+
+    /**
+     * @brief converts log level name (quiet, info, debug, trace) to log level.
+     * @param name(in): log level name.
+     * @return LogLevel: converted level, throws invalid_argument for unknown name.
+     */
+    static LogLevel parseLevel(const string &name)
+    {
+        static const pair<const char*, LogLevel> levels[] = {
+            {"quiet", LogLevel::Quiet}, {"info", LogLevel::Info}, {"debug", LogLevel::Debug}, {"trace", LogLevel::Trace}};
+        for (const auto &level : levels)
+        {
+            if (name == level.first)
+                return level.second;
+        }
+        throw invalid_argument("unknown log level : " + name);
+    }
+
+private:
+    static atomic<int>& runtimeLevel()
     {
-        cout << "VideoFrame destructor called : " << this << endl;
+        static atomic<int> level{static_cast<int>(LogLevel::Info)};
+        return level;
     }
-    uint8_t m_width; /**< width of frame . */
-    uint8_t m_height; /**< Height of frame . */
-    vector<vector<uint8_t>> m_pixels; /**< 2D vector of frame pixels. */
 };
 
 /**
- * @brief virtual class to define all common methods (pure virtual) to be able to create pipeline between elements.
+ * @brief logs message built with stream operators if level is enabled, nothing is evaluated otherwise.
+ * example : MD_LOG(LogLevel::Debug, "frame " << frameNumber);
  */
-class Element
+#define MD_LOG(level, message)                     \
+    do                                             \
+    {                                              \
+        if (Logger::isEnabled(level))              \
+        {                                          \
+            ostringstream logStream;               \
+            logStream << message;                  \
+            Logger::write(logStream.str());        \
+        }                                          \
+    } while (0)
+
+/**
+ * @brief non owning view of one row of pixels (width elements starting at data).
+ * it is lightweight (pointer + size) and it can be passed by value.
+ */
+template <typename T>
+class PixelRow
 {
 public:
     /**
-     * @brief pure virtual method to link element.
-     * @param element(in): output element to link.
-     * @return element(out): pointer to linked element.
-     */
-    virtual Element* link(Element *element) = 0;
-    /**
-     * @brief pure virtual method to process frame.
-     * @param videoFrame(in): shared pointer of video frame.
-     * @return void.
-     */
-    virtual void process(shared_ptr<VideoFrame> videoFrame) = 0;
-    /**
-     * @brief pure virtual method to process frame and forward video frame handling to next element.
-     * @param videoFrame(in): shared pointer of video frame.
-     * @return void.
+     * @brief PixelRow constructor.
+     * @param data(in): pointer to first pixel of row.
+     * @param size(in): number of pixels in row.
      */
-    virtual void processAndPushDownstream(shared_ptr<VideoFrame> videoFrame) = 0;
+    PixelRow(T *data, size_t size) : m_data(data), m_size(size)
+    {
+    }
+    T* begin() const { return m_data; }
+    T* end() const { return m_data + m_size; }
+    T* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    T& operator[](size_t index) const { return m_data[index]; }
+private:
+    T *m_data; /**< first pixel of row. */
+    size_t m_size; /**< number of pixels in row. */
 };
 
 /**
- * @brief base class for all elements of pipeline with implementation of generic methods (link, processAndPushDownstream).
+ * @brief rectangle of a detection in frame (pixels).
  */
-class BaseElement: public Element
+struct DetectionBox
 {
-private:
-    vector<Element*> m_nextElements; /**< vector to store all next elements in pipeline. */
+    uint32_t m_x; /**< column of first pixel. */
+    uint32_t m_y; /**< row of first pixel. */
+    uint32_t m_width; /**< number of columns. */
+    uint32_t m_height; /**< number of rows. */
+    uint32_t m_patternId = 0; /**< index of found pattern in patterns of detector. */
+};
 
+/**
+ * @brief annotation layer of a frame : detectors record found patterns here instead of altering
+ * pixels, so that a frame shared by several branches of pipeline is never written once generated
+ * and fan out needs no copy. boxes are protected by a mutex as detector and display of one frame
+ * may run in different threads.
+ */
+class DetectionOverlay
+{
 public:
     /**
-     * @brief BaseElement constructor.
+     * @brief adds a detection.
+     * @param box(in): rectangle of detection.
      */
-    BaseElement() : m_nextElements{}
+    void add(const DetectionBox &box)
     {
+        lock_guard<mutex> lock(m_lock);
+        m_boxes.push_back(box);
     }
+
     /**
-     * @brief BaseElement destructor.
+     * @brief copies current detections.
+     * @param boxes(out): detections, previous content is replaced.
      */
-    virtual ~BaseElement() = default;
+    void snapshot(vector<DetectionBox> &boxes) const
+    {
+        lock_guard<mutex> lock(m_lock);
+        boxes.assign(m_boxes.begin(), m_boxes.end());
+    }
 
     /**
-     * @brief implementation of link method. any new element to linked is pushed in internal vector.
-     * @param element(in): output element to link.
-     * @return element(out): pointer to linked element.
+     * @brief number of detections.
+     * @return size_t.
      */
-    Element* link(Element *element) override
+    size_t size() const
     {
-        m_nextElements.push_back(element);
-        return element;
+        lock_guard<mutex> lock(m_lock);
+        return m_boxes.size();
     }
 
     /**
-     * @brief implementation of processAndPushDownstream method.It loops in vector of next element to call
-     * process method of any next element and then call processAndPushDownstream method.
-     * @param videoFrame(in): shared pointer of video frame.
-     * @return void.
+     * @brief removes all detections.
      */
-    virtual void processAndPushDownstream(shared_ptr<VideoFrame> videoFrame) override
+    void clear()
     {
-        for_each(m_nextElements.cbegin(), m_nextElements.cend(), [&videoFrame](const auto &element) {
-            element->process(videoFrame); element->processAndPushDownstream(videoFrame);
-        });
+        lock_guard<mutex> lock(m_lock);
+        m_boxes.clear();
     }
-    friend class AsynchronousQueue; /**<  for AsynchronousQueue we have to reimplement some methods and access to private
-                                          members of private BasicElement members class. */
+
+private:
+    mutable mutex m_lock; /**< protects boxes. */
+    vector<DetectionBox> m_boxes; /**< detections in order of addition. */
 };
 
 /**
- * @brief video source element class to randomly generate frame video with a specified frame rate, width and height.
+ * @brief object placed in a frame by a synthetic source (ground truth of detection).
  */
-class VideoSourceElement: public BaseElement
+struct ObjectPlacement
 {
-public:
-    /**
-     * @brief VideoSourceElement constructor.
-     * @param width(in): width of frames to randomly generate.
-     * @param height(in): height of frames to randomly generate.
-     * @param frameRate(in): frequency of frame generation expressed in number of frames per second).
-     */
-    VideoSourceElement(uint8_t &width, uint8_t &height, uint8_t &frameRate) :
-            m_width(width), m_height(height), m_frameRate(frameRate), m_internalThread{}, m_runningState(false)
-    {
-    }
-    /**
-     * @brief VideoSourceElement Destructor.
-     */
-    ~VideoSourceElement()
-    {
-        stop();
-    }
+    size_t m_objectId; /**< index of object in scene. */
+    size_t m_shapeId; /**< index of object shape in scene shapes. */
+    DetectionBox m_box; /**< rectangle of object in frame. */
+};
+
+/**
+ * @brief changed (dirty) regions of a frame compared to a reference frame of same source (previous
+ * frame), computed by MotionDetectorElement or declared by frame generator. frame is split in blocks
+ * of block width x block height pixels (last column and last row of blocks may be partial), dirty
+ * rectangles are stored as dirty blocks covering them. when changes are not valid, all pixels of
+ * frame must be considered as changed.
+ * changes are frame metadata forwarded with frame to all downstream elements : an element altering
+ * pixels of a frame with valid changes has to add altered rectangles (addDirtyRegion), elements may
+ * skip work on clean regions (DetectorElement searches dirty windows, DisplayElement redraws dirty
+ * rows in InPlace mode).
+ */
+struct FrameChanges
+{
+    static constexpr size_t kDefaultBlockWidth = 64; /**< default columns of a block (one packed bits word). */
+    static constexpr size_t kDefaultBlockHeight = 8; /**< default rows of a block. */
+
+    bool m_valid = false; /**< true when dirty blocks are known. */
+    uint64_t m_referenceSequence = 0; /**< sequence number of reference frame. */
+    size_t m_blockWidth = 0; /**< columns of a block. */
+    size_t m_blockHeight = 0; /**< rows of a block. */
+    size_t m_blockColumns = 0; /**< number of blocks per row of blocks. */
+    size_t m_blockRows = 0; /**< number of rows of blocks. */
+    size_t m_width = 0; /**< frame width. */
+    size_t m_height = 0; /**< frame height. */
+    size_t m_dirtyCount = 0; /**< number of changed blocks. */
+    vector<uint8_t> m_dirtyBlocks; /**< 1 for a changed block, row major. */
+    vector<uint8_t> m_dirtyRows; /**< 1 for a row of blocks with at least one changed block. */
 
     /**
-     * @brief starts thread to generate frames and then we will be blocked until join of thread (stop of it).
+     * @brief sizes blocks grid for a frame, all blocks clean, changes become valid.
+     * @param width(in): frame width.
+     * @param height(in): frame height.
+     * @param blockWidth(in): columns of a block (> 0).
+     * @param blockHeight(in): rows of a block (> 0).
+     * @param referenceSequence(in): sequence number of reference frame.
      */
-    void start()
+    void reset(size_t width, size_t height, size_t blockWidth, size_t blockHeight, uint64_t referenceSequence)
     {
-        if (!m_runningState)
-        {
-            m_runningState = true;
-            m_internalThread = thread(&VideoSourceElement::RandomVideoFramesGenerator, this);
-        }
-
-        if (m_internalThread.joinable())
-            m_internalThread.join();
+        m_valid = true;
+        m_referenceSequence = referenceSequence;
+        m_blockWidth = blockWidth;
+        m_blockHeight = blockHeight;
+        m_blockColumns = (width + blockWidth - 1) / blockWidth;
+        m_blockRows = (height + blockHeight - 1) / blockHeight;
+        m_width = width;
+        m_height = height;
+        m_dirtyCount = 0;
+        m_dirtyBlocks.assign(m_blockColumns * m_blockRows, 0);
+        m_dirtyRows.assign(m_blockRows, 0);
     }
 
     /**
-     * @brief stops thread to generate frames if already started.
+     * @brief marks a block as changed.
+     * @param column(in): block column.
+     * @param row(in): block row.
      */
-    void stop ()
+    void markDirty(size_t column, size_t row)
     {
-        if (m_runningState)
-        {
-            m_runningState = false;
-            if (m_internalThread.joinable())
-                m_internalThread.join();
-        }
+        uint8_t &block = m_dirtyBlocks[row * m_blockColumns + column];
+        m_dirtyCount += !block;
+        block = 1;
+        m_dirtyRows[row] = 1;
     }
 
     /**
-     * @brief first node in pipeline. Video source generates random frame and forward it for processing
-     * to next element.
-     * @param videoFrame(in): shared pointer of video frame.
-     * @return void.
+     * @brief marks blocks covering a rectangle as changed (rectangle is clipped to frame).
+     * @param region(in): changed rectangle.
      */
-    void process(shared_ptr<VideoFrame> videoFrame) override
+    void addDirtyRegion(const DetectionBox &region)
     {
-        processAndPushDownstream(videoFrame);
+        if ((region.m_width == 0) || (region.m_height == 0) || (region.m_x >= m_width) || (region.m_y >= m_height))
+            return;
+        const size_t lastColumn = min<size_t>(region.m_x + region.m_width, m_width) - 1;
+        const size_t lastRow = min<size_t>(region.m_y + region.m_height, m_height) - 1;
+        for (size_t row = region.m_y / m_blockHeight; row <= lastRow / m_blockHeight; row++)
+            for (size_t column = region.m_x / m_blockWidth; column <= lastColumn / m_blockWidth; column++)
+                markDirty(column, row);
     }
-private:
-    uint8_t m_width; /**< width of frame . */
-    uint8_t m_height;/**< height of frame . */
-    uint8_t m_frameRate; /**< frame rate : frequency of frame generation expressed in frame per second. */
-    thread m_internalThread;/**< thread used to generate random frames. */
-    bool m_runningState;/**< boolean to keep status of thread running true : run false : down. */
-    shared_ptr<VideoFrame> m_videoFrame;/**< shared pointer of video frame. */
 
     /**
-     * @brief method executes inside thread to generate random frames.
-     * it generates frame push frame to next element and sleep time according
-     * to frame rate specified by user for example for framerate =10 frame per seconds
-     * it will sleep 100 ms between each frame generation.
-     * it can be interrupted by setting m_runningState to false
-     * @param void.
-     * @return void.
+     * @brief dirty rectangles : one rectangle per run of consecutive dirty blocks of a row of blocks,
+     * clipped to frame.
+     * @param regions(out): dirty rectangles, previous content is replaced.
      */
-    void RandomVideoFramesGenerator(void)
+    void dirtyRegions(vector<DetectionBox> &regions) const
     {
-        while (m_runningState)
+        regions.clear();
+        for (size_t row = 0; row < m_blockRows; row++)
         {
-            processAndPushDownstream(GenerateVideoFrame());
-            this_thread::sleep_for(chrono::milliseconds(1000 / m_frameRate));
+            for (size_t column = 0; m_dirtyRows[row] && (column < m_blockColumns); column++)
+            {
+                if (!isDirty(column, row))
+                    continue;
+                const size_t first = column;
+                while ((column + 1 < m_blockColumns) && isDirty(column + 1, row))
+                    column++;
+                const size_t x = first * m_blockWidth;
+                const size_t y = row * m_blockHeight;
+                regions.push_back(DetectionBox{static_cast<uint32_t>(x), static_cast<uint32_t>(y),
+                                               static_cast<uint32_t>(min((column + 1) * m_blockWidth, m_width) - x),
+                                               static_cast<uint32_t>(min(y + m_blockHeight, m_height) - y)});
+            }
         }
     }
 
+    bool isDirty(size_t column, size_t row) const { return m_dirtyBlocks[row * m_blockColumns + column]; }
+    bool isRowDirty(size_t row) const { return m_dirtyRows[row]; }
+
     /**
-     * @brief method to generate randomly Video Frame.
-     * uniform_int_distribution is used in order to generate random value
-     * in set {0, 1}. pixels are two colors encoded.
-     * it fill shared pointer with generated frame video and returns shared pointer.
-     * @param void.
-     * @return VideoFrame : shared pointer with generated video frame.
+     * @brief checks if a window of frame overlaps a changed block.
+     * @param x(in): first column of window.
+     * @param y(in): first row of window.
+     * @param width(in): columns of window (> 0).
+     * @param height(in): rows of window (> 0).
+     * @return bool: true if at least one pixel of window may have changed.
      */
-    shared_ptr<VideoFrame> GenerateVideoFrame(void)
+    bool isWindowDirty(size_t x, size_t y, size_t width, size_t height) const
     {
-        random_device rd;  //Will be used to obtain a seed for the random number engine
-        mt19937 gen(rd()); //Standard mersenne_twister_engine seeded with rd()
-        uniform_int_distribution<> distrib(0, 1);
-
-        cout << "\n New Frame Generated Width : " << unsigned(m_width) << " Height : " << unsigned(m_height) << "\n";
-
-        vector<vector<uint8_t>> m_pixels;
-        for (int i = 0; i < m_height; i++)
+        for (size_t row = y / m_blockHeight; row <= (y + height - 1) / m_blockHeight; row++)
         {
-            vector<uint8_t> line;
-            for (int j = 0; j < m_width; j++)
-            {
-                line.push_back(distrib(gen));
-                cout << unsigned(line[j]) << " ";
-            }
-            cout << "\n";
-            m_pixels.push_back(line);
+            if (!m_dirtyRows[row])
+                continue;
+            for (size_t column = x / m_blockWidth; column <= (x + width - 1) / m_blockWidth; column++)
+                if (isDirty(column, row))
+                    return true;
         }
-
-        cout << "\n";
-        cout << "GenerateVideoFrame before make shared counter : " << m_videoFrame.use_count() << " pointer " << m_videoFrame.get() << "\n";
-        m_videoFrame = make_shared<VideoFrame>(m_width, m_height, m_pixels);
-
-        return m_videoFrame;
+        return false;
     }
 };
 
 /**
- * @brief display element to process frame rate and display it in stdout.
+ * @brief summed area table of non zero pixels of a frame : entry (x, y) is number of non zero pixels
+ * in [0, x) x [0, y), so that non zero pixels of any window are counted in O(1).
+ * table is built lazily from top rows and extended on demand up to rows needed by callers, built
+ * rows are never rewritten so that readers of built rows need no lock.
  */
-class DisplayElement: public BaseElement
+class SummedAreaTable
 {
 public:
     /**
-     * @brief DisplayElement Constructor.
-     */
-    DisplayElement()
-    {
-    }
-    /**
-     * @brief DisplayElement Destructor.
+     * @brief number of non zero pixels of a window (rows of window must be built).
+     * @param x(in): first column of window.
+     * @param y(in): first row of window.
+     * @param width(in): columns of window.
+     * @param height(in): rows of window.
+     * @return uint32_t: non zero pixels count.
      */
-    ~DisplayElement()
+    uint32_t count(size_t x, size_t y, size_t width, size_t height) const
     {
+        const uint32_t *top = m_sums.data() + y * (m_width + 1);
+        const uint32_t *bottom = top + height * (m_width + 1);
+        return bottom[x + width] - top[x + width] - bottom[x] + top[x];
     }
 
+private:
+    friend class VideoFrame;
+
     /**
-     * @brief process frame to print it in stdout (pixel 1 -> '+' 0 -> '.').
-     * @param videoFrame(in): shared pointer of video frame.
-     * @return void.
+     * @brief forgets built rows (pixels of frame changed).
      */
-    void process(shared_ptr<VideoFrame> videoFrame) override
+    void invalidate()
     {
-        printVideoFrame(videoFrame);
+        lock_guard<mutex> lock(m_lock);
+        m_builtRows = 0;
     }
 
     /**
-     * @brief process frame to print it in stdout (pixel 1 -> '+' 0 -> '.').
-     * @param videoFrame(in): shared pointer of video frame.
-     * @return void.
+     * @brief builds table up to a number of rows of frame if not already built.
+     * @param pixels(in): first pixel of frame.
+     * @param stride(in): distance in bytes between rows of frame.
+     * @param width(in): frame width.
+     * @param height(in): frame height.
+     * @param rows(in): number of top rows of frame needed.
+     * @param packed(in): rows are 64 pixels words (one bit per pixel, see PixelFormat::Mono1) instead of bytes.
      */
-    void printVideoFrame(shared_ptr<VideoFrame> videoFrame)
+    void build(const uint8_t *pixels, size_t stride, size_t width, size_t height, size_t rows, bool packed)
     {
-        cout << "\n New Frame Width : " << unsigned(videoFrame->m_width) << " Height : " << unsigned(videoFrame->m_height) << "\n";
-        for_each(videoFrame->m_pixels.cbegin(), videoFrame->m_pixels.cend(), [](const auto &raw)
+        lock_guard<mutex> lock(m_lock);
+        rows = min(rows, height);
+        if (m_builtRows == 0)
         {
-            for_each(raw.cbegin(), raw.cend(), [](const auto &pixel) {
-                cout << ((pixel == 2) ? "$ " : ((pixel == 1) ? "+ " :". "));
-            });
-            cout << "\n";
-        });
-        cout << "\n";
+            // storage is kept between frames, only first row and first column are zero
+            m_width = width;
+            m_sums.resize((width + 1) * (height + 1));
+            fill_n(m_sums.begin(), width + 1, 0);
+        }
+        for (size_t y = m_builtRows; y < rows; y++)
+        {
+            const uint8_t *row = pixels + y * stride;
+            const uint32_t *above = m_sums.data() + y * (width + 1);
+            uint32_t *sums = m_sums.data() + (y + 1) * (width + 1);
+            const uint64_t *words = reinterpret_cast<const uint64_t*>(row);
+            uint32_t rowSum = 0;
+            sums[0] = 0;
+            if (packed)
+            {
+                for (size_t x = 0; x < width; x++)
+                {
+                    rowSum += (words[x / 64] >> (x % 64)) & 1;
+                    sums[x + 1] = above[x + 1] + rowSum;
+                }
+                continue;
+            }
+            for (size_t x = 0; x < width; x++)
+            {
+                rowSum += (row[x] != 0);
+                sums[x + 1] = above[x + 1] + rowSum;
+            }
+        }
+        m_builtRows = max(m_builtRows, rows);
     }
+
+    mutex m_lock; /**< serializes builds. */
+    size_t m_width = 0; /**< frame width. */
+    size_t m_builtRows = 0; /**< number of built rows of frame. */
+    vector<uint32_t> m_sums; /**< (width + 1) * (height + 1) sums, row major. */
 };
 
 /**
- * @brief detector element to find specific patterns in frame rate and mark it
- * for print with different value.
+ * @brief core affinity and NUMA placement of pipeline threads and frame buffers (Linux, no effect
+ * on other systems) : a producer and its consumer pinned to cores of one node, with frames allocated
+ * on that node, keep every frame out of the interconnect between sockets.
  */
-class DetectorElement: public BaseElement
+class CpuAffinity
 {
 public:
     /**
-     * @brief DetectorElement constructor.
-     * @param pattern(in): pattern to find inside/mark it inside video frame.
+     * @brief parses a cpu list as in /sys (for instance 0-3,8,10-11).
+     * @param list(in): cpu list.
+     * @return vector<unsigned>: cpus in order of list, throws invalid_argument for a malformed list.
      */
-    DetectorElement(vector<vector<uint8_t>> &pattern) :
-            m_patternToDetect(pattern)
+    static vector<unsigned> parseCpuList(const string &list)
     {
+        vector<unsigned> cpus;
+        istringstream ranges(list);
+        for (string range; getline(ranges, range, ',');)
+        {
+            const size_t dash = range.find('-');
+            const unsigned first = parseCpu(range.substr(0, dash), list);
+            const unsigned last = (dash == string::npos) ? first : parseCpu(range.substr(dash + 1), list);
+            if (last < first)
+                throw invalid_argument("invalid cpu list : " + list);
+            for (unsigned cpu = first; cpu <= last; cpu++)
+                cpus.push_back(cpu);
+        }
+        if (cpus.empty())
+            throw invalid_argument("empty cpu list");
+        return cpus;
     }
 
     /**
-     * @brief DetectorElement Destructor.
+     * @brief restricts a thread to cpus.
+     * @param handle(in): native handle of thread.
+     * @param cpus(in): allowed cpus, empty for no restriction (any cpu).
+     * @return bool: false if thread could not be pinned (cpu out of range or not allowed).
      */
-    ~DetectorElement()
+    static bool pin(thread::native_handle_type handle, const vector<unsigned> &cpus)
     {
+        if (cpus.empty())
+            return true;
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (const auto cpu : cpus)
+        {
+            if (cpu >= CPU_SETSIZE)
+                return false;
+            CPU_SET(cpu, &set);
+        }
+        const bool pinned = pthread_setaffinity_np(handle, sizeof(set), &set) == 0;
+        if (!pinned)
+            MD_LOG(LogLevel::Info, "CpuAffinity cannot pin thread to cpus " << formatCpuList(cpus) << "\n");
+        return pinned;
+#else
+        (void)handle;
+        return false;
+#endif
     }
 
     /**
-     * @brief to process frame video in order to find and mark specified pattern.
-     * @param videoFrame(in): shared pointer of video frame.
-     * @return void.
+     * @brief restricts a thread to one cpu of a list (round robin by index), so that workers of a
+     * pool are spread on distinct cores.
+     * @param handle(in): native handle of thread.
+     * @param cpus(in): cpus, empty for no restriction.
+     * @param index(in): index of thread in its pool.
+     * @return bool: see pin.
      */
-    void process(shared_ptr<VideoFrame> videoFrame) override
+    static bool pinOne(thread::native_handle_type handle, const vector<unsigned> &cpus, size_t index)
     {
-        checkPatternAndMarkExistingPatterns(videoFrame);
+        return cpus.empty() || pin(handle, {cpus[index % cpus.size()]});
     }
 
-private:
-
     /**
-     * @brief once pattern found this method will alter values of pattern to change them
-     * from 1 to 2 (note that 0 pixels of found pattern remains unchanged).
-     * @param videoFrame(in): shared pointer of video frame.
-     * @param xPosition(in): x position of found pattern.
-     * @param yPosition(in): y position of found pattern.
-     * @return void.
+     * @brief NUMA node of a cpu.
+     * @param cpu(in): cpu index.
+     * @return int: node, -1 if unknown (no NUMA information).
      */
-    void markPattern(shared_ptr<VideoFrame> videoFrame, uint8_t xPosition, uint8_t yPosition)
+    static int nodeOfCpu(unsigned cpu)
     {
-        for (auto k = yPosition; k < (yPosition + m_patternToDetect.size()); k++)
+        ifstream online("/sys/devices/system/node/online");
+        string nodes;
+        if (!getline(online, nodes))
+            return -1;
+        try
         {
-            for (auto h = xPosition; h < (xPosition + m_patternToDetect[0].size()); h++)
+            for (const auto node : parseCpuList(nodes))
             {
-                videoFrame->m_pixels[k][h] = (videoFrame->m_pixels[k][h] > 0 ? 2 : videoFrame->m_pixels[k][h]);
+                ifstream file("/sys/devices/system/node/node" + to_string(node) + "/cpulist");
+                string cpus;
+                if (getline(file, cpus) && !cpus.empty())
+                {
+                    const auto nodeCpus = parseCpuList(cpus);
+                    if (find(nodeCpus.begin(), nodeCpus.end(), cpu) != nodeCpus.end())
+                        return static_cast<int>(node);
+                }
             }
+        } catch (const invalid_argument &)
+        {
         }
+        return -1;
     }
 
     /**
-     * @brief Checks all occurrences of pattern in a video frame.
-     * all found patterns are marked by changed 1 value to 2 (see markPattern method.)
-     * @param videoFrame(in): shared pointer of video frame.
-     * @return void.
+     * @brief asks kernel to allocate pages of a memory range on a node (preferred node, memory of
+     * other nodes is used when node is full). to be called before first touch of pages.
+     * @param address(in): page aligned first byte of range.
+     * @param size(in): size of range in bytes.
+     * @param node(in): NUMA node.
+     * @return bool: false if policy could not be set.
      */
-    void checkPatternAndMarkExistingPatterns(shared_ptr<VideoFrame> videoFrame)
+    static bool bindToNode(void *address, size_t size, int node)
     {
-        vector<vector<uint8_t>> pixels = videoFrame->m_pixels;
-        bool found = false;
-
-        // checks if width or height of pattern bigger then video frame which means pattern cannot be found
-        if ((pixels.size() < m_patternToDetect.size()) || (pixels[0].size() < m_patternToDetect[0].size()))
-        {
-            return;
-        }
-
-        for (int j = 0; j < (pixels.size() - m_patternToDetect.size()); j++)
-        {
-            // fix raw j from input frame video
-            vector<uint8_t> raw = pixels[j];
-            // try to search first raw of pattern in each raw
-            vector<uint8_t> raw_pattern = m_patternToDetect[0];
-            // loop in pixels of frame video raw to find first raw from pattern
-            for (auto i = 0; i < (raw.size() - raw_pattern.size()); i++)
-            {
-                found = equal(m_patternToDetect[0].begin(), m_patternToDetect[0].end(), raw.begin() + i);
-                // first raw found look to other raws from pattern in next raws from current frame video raw
-                // in same positions j for raw and i for pixel position
-                if (found)
-                {
-                    // loop here for all next element of pattern to check if they exists in next raws from video frame
-                    for (auto k = 1; k < m_patternToDetect.size(); k++)
-                    {
-                        found = equal(m_patternToDetect[k].begin(), m_patternToDetect[k].end(), pixels[j + k].begin() + i);
-                        // no found then continue looping
-                        if (!found)
-                            break;
-                    }
-
-                    // all elements from pattern found in following position (j, i)
-                    if (found)
-                    {
-                        cout << "***** PATTERN FOUND AT POSITION j : " << j << " i : " << i << " ******\n";
-                        // mark pattern for display with '$'
-                        markPattern(videoFrame, i, j);
-                    }
-                }
-            }
-        }
+#if defined(__linux__)
+        if ((node < 0) || (node >= static_cast<int>(sizeof(unsigned long) * CHAR_BIT)))
+            return false;
+        const unsigned long nodeMask = 1ul << node;
+        return syscall(SYS_mbind, address, size, MPOL_PREFERRED, &nodeMask, sizeof(nodeMask) * CHAR_BIT, 0) == 0;
+#else
+        (void)address;
+        (void)size;
+        (void)node;
+        return false;
+#endif
     }
-    vector<vector<uint8_t>> m_patternToDetect;/**< pattern to detect. */
-};
 
-/**
- * @brief Asynchronous queue element it will be inserted in pipeline in order
- * to avoid blocking pipeline processing by any heavy processing element(detector for example).
- */
-class AsynchronousQueue: public BaseElement
-{
-public:
     /**
-     * @brief AsynchronousQueue constructor
-     * @param queueMaxSize(in): authorized max queue size in terms
-     * of number of frames.
-     * @return void.
+     * @brief formats cpus as a list.
+     * @param cpus(in): cpus.
+     * @return string: cpus separated by commas.
      */
-    AsynchronousQueue(uint8_t queueMaxSize) :
-            m_runningState(false),
-            m_startedState(false),
-            m_internalThread{},
-            m_queueMaxSize(queueMaxSize)
+    static string formatCpuList(const vector<unsigned> &cpus)
     {
+        string list;
+        for (const auto cpu : cpus)
+            list += (list.empty() ? "" : ",") + to_string(cpu);
+        return list;
     }
 
+private:
     /**
-     * @brief AsynchronousQueue destructor it will
-     * interrupt thread by setting running state to false
-     * unblock it if thread is sleeping waiting for a conditional
-     * variable notification.Also waits to join thread before empty
-     * free all queue content.
+     * @brief parses a cpu index of a cpu list.
+     * @param value(in): decimal digits.
+     * @param list(in): whole list (for error message).
+     * @return unsigned: cpu index.
      */
-    ~AsynchronousQueue()
+    static unsigned parseCpu(const string &value, const string &list)
     {
-        m_runningState = false;
+        if (value.empty() || (value.size() > 6) || (value.find_first_not_of("0123456789") != string::npos))
+            throw invalid_argument("invalid cpu list : " + list);
+        return static_cast<unsigned>(stoul(value));
+    }
+};
+
+/**
+ * @brief pixels formats of video frames.
+ */
+enum class PixelFormat : int
+{
+    Gray8 = 0, /**< one byte per pixel : 0, 1 or 2 for a pixel of a marked pattern. */
+    Mono1 = 1, /**< one bit per pixel (pixel j of a 64 pixels word is bit j) and a 1 bit per pixel match mask plane. */
+};
+
+/**
+ * @brief values of 8 pixels (0 or 1) for each byte value : pixel k is bit k of byte.
+ */
+static constexpr array<array<uint8_t, 8>, 256> kBitsToPixels = []
+{
+    array<array<uint8_t, 8>, 256> table{};
+    for (size_t value = 0; value < table.size(); value++)
+        for (size_t bit = 0; bit < 8; bit++)
+            table[value][bit] = (value >> bit) & 1;
+    return table;
+}();
+
+/**
+ * @brief bits of a 64 pixels word inside a range of pixels of a row.
+ * @param word(in): index of word in row.
+ * @param first(in): first pixel of range.
+ * @param last(in): end of range (exclusive), word must overlap [first, last).
+ * @return uint64_t: mask of pixels of word inside range.
+ */
+inline uint64_t bitRangeMask(size_t word, size_t first, size_t last)
+{
+    uint64_t mask = ~uint64_t(0);
+    if (word == first / 64)
+        mask &= ~uint64_t(0) << (first % 64);
+    if ((word + 1) * 64 > last)
+        mask &= ~uint64_t(0) >> (64 - last % 64);
+    return mask;
+}
+
+/**
+ * @brief VideoFrame class to store pixels and video Frame size (width && height).
+ * pixels are stored in one contiguous buffer aligned on kRowAlignment, each row
+ * starts at (row index * stride) where stride is width rounded up to kRowAlignment.
+ * Mono1 frames store rows of 64 pixels words (stride is bytes of words rounded up to kRowAlignment,
+ * bits beyond width are 0) followed by match mask plane of same layout : pixels of matched patterns
+ * are flagged in mask instead of being rewritten, so that pixels stay 1 bit values. Mono1 frames
+ * need 8 times less memory (and memory traffic) than Gray8 ones, see convertPixels and unpackRow for
+ * byte conversions.
+ */
+class VideoFrame
+{
+public:
+    static constexpr size_t kRowAlignment = 64; /**< alignment of buffer and rows (cache line size). */
+
+    /**
+     * @brief video frame class constructor. pixels buffer is allocated and zero filled.
+     * @param width(in): video frame width.
+     * @param height(in): video frame Height.
+     * @param format(in): pixels format.
+     * @param numaNode(in): NUMA node of pixels buffer (page aligned, see CpuAffinity::bindToNode), -1 for
+     * pages of node of first touching (allocating) thread.
+     */
+    VideoFrame(uint32_t width, uint32_t height, PixelFormat format = PixelFormat::Gray8, int numaNode = -1) :
+            m_width(width), m_height(height), m_sequenceNumber(0), m_captureTimestamp{}, m_overlay{}, m_groundTruth{},
+            m_changes{}, m_format(format),
+            m_stride(alignedStride((format == PixelFormat::Mono1) ? ((width + 63) / 64) * sizeof(uint64_t) : width)),
+            m_buffer(allocatePixels(m_stride * height * ((format == PixelFormat::Mono1) ? 2 : 1), numaNode)), m_pixels(m_buffer.get()),
+            m_matchMaskUsed(false)
+    {
+        MD_LOG(LogLevel::Debug, "VideoFrame constructor called : " << this << "\n");
+    }
+    /**
+     * @brief video frame view constructor : Gray8 pixels are not copied, they stay in memory of a
+     * reader (for instance a memory mapped raw file) kept alive by frame.
+     * @param width(in): video frame width.
+     * @param height(in): video frame Height.
+     * @param pixels(in): first pixel of frame, writable (elements may mark pixels).
+     * @param stride(in): distance in bytes between two rows (>= width).
+     * @param storage(in): owner of pixels memory, released with frame.
+     */
+    VideoFrame(uint32_t width, uint32_t height, uint8_t *pixels, size_t stride, shared_ptr<void> storage) :
+            m_width(width), m_height(height), m_sequenceNumber(0), m_captureTimestamp{}, m_overlay{}, m_groundTruth{},
+            m_changes{}, m_format(PixelFormat::Gray8), m_stride(stride), m_buffer{}, m_pixels(pixels), m_storage(move(storage)),
+            m_matchMaskUsed(false)
+    {
+        if ((pixels == nullptr) || (stride < width))
+            throw invalid_argument("VideoFrame view needs pixels and a stride not lower than width");
+        MD_LOG(LogLevel::Debug, "VideoFrame view constructor called : " << this << "\n");
+    }
+    /**
+     * @brief video frame class destructor.
+     */
+    ~VideoFrame()
+    {
+        MD_LOG(LogLevel::Debug, "VideoFrame destructor called : " << this << "\n");
+    }
+    VideoFrame(const VideoFrame &) = delete; /**< frames are shared (shared_ptr) never deep copied implicitly. */
+    VideoFrame& operator=(const VideoFrame &) = delete;
+
+    /**
+     * @brief pixels format of frame.
+     * @return PixelFormat.
+     */
+    PixelFormat format() const
+    {
+        return m_format;
+    }
+
+    /**
+     * @brief checks if pixels are a view of memory of a reader (see view constructor).
+     * @return bool: true for a view, false for pixels owned by frame.
+     */
+    bool isView() const
+    {
+        return !m_buffer;
+    }
+
+    /**
+     * @brief distance in bytes between first pixels of two consecutive rows.
+     * @return stride in bytes.
+     */
+    size_t stride() const
+    {
+        return m_stride;
+    }
+
+    /**
+     * @brief raw access to contiguous pixels buffer (height * stride bytes, followed by match mask plane
+     * for Mono1 frames).
+     * @return pointer to first pixel of frame.
+     */
+    uint8_t* data()
+    {
+        return m_pixels;
+    }
+    const uint8_t* data() const
+    {
+        return m_pixels;
+    }
+
+    /**
+     * @brief row accessor of Gray8 frame (see bits for Mono1 frames).
+     * @param y(in): row index (0 <= y < height).
+     * @return view of width pixels of row y.
+     */
+    PixelRow<uint8_t> row(size_t y)
+    {
+        return PixelRow<uint8_t>(m_pixels + y * m_stride, m_width);
+    }
+    PixelRow<const uint8_t> row(size_t y) const
+    {
+        return PixelRow<const uint8_t>(m_pixels + y * m_stride, m_width);
+    }
+
+    /**
+     * @brief pixel accessor of Gray8 frame (see pixelValue for any format).
+     * @param x(in): column index.
+     * @param y(in): row index.
+     * @return reference to pixel (x, y).
+     */
+    uint8_t& pixel(size_t x, size_t y)
+    {
+        return m_pixels[y * m_stride + x];
+    }
+    uint8_t pixel(size_t x, size_t y) const
+    {
+        return m_pixels[y * m_stride + x];
+    }
+
+    /**
+     * @brief value of a pixel whatever format of frame (a flagged pixel of Mono1 match mask is 2).
+     * @param x(in): column index.
+     * @param y(in): row index.
+     * @return uint8_t: pixel value.
+     */
+    uint8_t pixelValue(size_t x, size_t y) const
+    {
+        if (m_format == PixelFormat::Gray8)
+            return pixel(x, y);
+        return ((bits(y)[x / 64] >> (x % 64)) & 1) + ((matchMask(y)[x / 64] >> (x % 64)) & 1);
+    }
+
+    /**
+     * @brief number of 64 pixels words of a row of Mono1 frame.
+     * @return size_t: words per row.
+     */
+    size_t wordsPerRow() const
+    {
+        return (m_width + 63) / 64;
+    }
+
+    /**
+     * @brief words accessor of Mono1 frame, bits beyond width must stay 0.
+     * @param y(in): row index (0 <= y < height).
+     * @return pointer to wordsPerRow words of row y.
+     */
+    uint64_t* bits(size_t y)
+    {
+        return reinterpret_cast<uint64_t*>(m_pixels + y * m_stride);
+    }
+    const uint64_t* bits(size_t y) const
+    {
+        return reinterpret_cast<const uint64_t*>(m_pixels + y * m_stride);
+    }
+
+    /**
+     * @brief match mask accessor of Mono1 frame (see markMatch).
+     * @param y(in): row index (0 <= y < height).
+     * @return pointer to wordsPerRow words of match mask of row y.
+     */
+    const uint64_t* matchMask(size_t y) const
+    {
+        return reinterpret_cast<const uint64_t*>(m_pixels + (m_height + y) * m_stride);
+    }
+
+    /**
+     * @brief flags 1 pixels of a range of a row of Mono1 frame in match mask (0 pixels of a found
+     * pattern remain unflagged, like marking of Gray8 pixels).
+     * @param x(in): first column of range.
+     * @param y(in): row index.
+     * @param count(in): columns of range.
+     */
+    void markMatch(size_t x, size_t y, size_t count)
+    {
+        if (count == 0)
+            return;
+        const uint64_t *pixels = bits(y);
+        uint64_t *mask = reinterpret_cast<uint64_t*>(m_pixels + (m_height + y) * m_stride);
+        for (size_t word = x / 64; word * 64 < x + count; word++)
+            mask[word] |= pixels[word] & bitRangeMask(word, x, x + count);
+        m_matchMaskUsed = true;
+    }
+
+    /**
+     * @brief unflags all pixels of match mask of Mono1 frame (nothing to do if no match was flagged).
+     */
+    void clearMatchMask()
+    {
+        if (!m_matchMaskUsed)
+            return;
+        memset(m_pixels + m_height * m_stride, 0, m_height * m_stride);
+        m_matchMaskUsed = false;
+    }
+
+    /**
+     * @brief writes width pixel values of a row as bytes (0, 1, or 2 for marked pixels), for instance
+     * to display a Mono1 frame.
+     * @param y(in): row index.
+     * @param pixels(out): width bytes.
+     */
+    void unpackRow(size_t y, uint8_t *pixels) const
+    {
+        if (m_format == PixelFormat::Gray8)
+        {
+            memcpy(pixels, row(y).data(), m_width);
+            return;
+        }
+        const uint64_t *ones = bits(y);
+        const uint64_t *marked = matchMask(y);
+        for (size_t word = 0; word * 64 < m_width; word++)
+        {
+            uint64_t onesWord = ones[word];
+            uint64_t markedWord = m_matchMaskUsed ? marked[word] : 0;
+            const size_t count = min<size_t>(64, m_width - word * 64);
+            for (size_t k = 0; k < count; k += 8, onesWord >>= 8, markedWord >>= 8)
+            {
+                // bytes are 0 or 1, sum of 8 bytes at once has no carry
+                uint64_t values;
+                uint64_t flags;
+                memcpy(&values, kBitsToPixels[onesWord & 0xff].data(), 8);
+                memcpy(&flags, kBitsToPixels[markedWord & 0xff].data(), 8);
+                values += flags;
+                memcpy(pixels + word * 64 + k, &values, min<size_t>(8, count - k));
+            }
+        }
+    }
+
+    /**
+     * @brief writes width pixel values of a row from bytes : non zero pixels are 1 bits of Mono1 frame
+     * and pixels equal to 2 are flagged in its match mask.
+     * @param y(in): row index.
+     * @param pixels(in): width bytes.
+     */
+    void packRow(size_t y, const uint8_t *pixels)
+    {
+        if (m_format == PixelFormat::Gray8)
+        {
+            memcpy(row(y).data(), pixels, m_width);
+            return;
+        }
+        uint64_t *ones = bits(y);
+        uint64_t *marked = reinterpret_cast<uint64_t*>(m_pixels + (m_height + y) * m_stride);
+        for (size_t word = 0; word * 64 < m_width; word++)
+        {
+            const size_t count = min<size_t>(64, m_width - word * 64);
+            uint64_t onesWord = 0;
+            uint64_t markedWord = 0;
+            for (size_t k = 0; k < count; k += 8)
+            {
+                // 8 pixels at once : high bit of each byte tells byte is non zero (or equal to 2)
+                uint64_t values = 0;
+                memcpy(&values, pixels + word * 64 + k, min<size_t>(8, count - k));
+                onesWord |= gatherHighBits(nonZeroBytes(values)) << k;
+                markedWord |= gatherHighBits(~nonZeroBytes(values ^ 0x0202020202020202ull) & 0x8080808080808080ull) << k;
+            }
+            // bytes beyond width were read as 0, they are flagged as not equal to 2
+            markedWord &= bitRangeMask(0, 0, count);
+            ones[word] = onesWord;
+            m_matchMaskUsed |= (markedWord != 0);
+            marked[word] = markedWord;
+        }
+    }
+
+    /**
+     * @brief copies pixels of a frame of same size converting them to format of this frame (metadata
+     * is not copied, see clone).
+     * @param source(in): frame to copy, throws invalid_argument if its size differs.
+     */
+    void convertPixels(const VideoFrame &source)
+    {
+        if ((source.m_width != m_width) || (source.m_height != m_height))
+            throw invalid_argument("VideoFrame pixels conversion needs frames of same size");
+        invalidateSummedAreaTable();
+        if ((source.m_format == m_format) && (source.m_stride == m_stride))
+        {
+            memcpy(data(), source.data(), m_stride * m_height * ((m_format == PixelFormat::Mono1) ? 2 : 1));
+            m_matchMaskUsed = source.m_matchMaskUsed;
+            return;
+        }
+        if (source.m_format == m_format)
+        {
+            // view of a reader : Gray8 rows of another stride
+            for (size_t y = 0; y < m_height; y++)
+                memcpy(row(y).data(), source.row(y).data(), m_width);
+            return;
+        }
+        convertRows(source, 0, m_height);
+    }
+
+    /**
+     * @brief converts rows [firstRow, lastRow) of a frame of same size and other format to format of
+     * this frame, so that a frame can be converted by bands (summed area table of this frame must be
+     * invalidated before first band and built only from converted rows).
+     * @param source(in): frame to copy.
+     * @param firstRow(in): first converted row.
+     * @param lastRow(in): end of converted rows.
+     */
+    void convertRows(const VideoFrame &source, size_t firstRow, size_t lastRow)
+    {
+        for (size_t y = firstRow; y < lastRow; y++)
+        {
+            if (m_format == PixelFormat::Mono1)
+                packRow(y, source.row(y).data());
+            else
+                source.unpackRow(y, row(y).data());
+        }
+    }
+
+    /**
+     * @brief summed area table of non zero pixels built once per frame and shared by all elements
+     * needing it (first caller builds it, next ones only extend it when they need more rows).
+     * pixels of frame must not change once table is built (see invalidateSummedAreaTable).
+     * @param rows(in): number of top rows of frame needed.
+     * @return SummedAreaTable: table with at least rows built.
+     */
+    const SummedAreaTable& summedAreaTable(size_t rows) const
+    {
+        m_summedAreaTable.build(data(), m_stride, m_width, m_height, rows, m_format == PixelFormat::Mono1);
+        return m_summedAreaTable;
+    }
+
+    /**
+     * @brief forgets summed area table after pixels change.
+     */
+    void invalidateSummedAreaTable()
+    {
+        m_summedAreaTable.invalidate();
+    }
+
+    /**
+     * @brief explicit deep copy of frame (pixels, metadata and overlay) for an element which needs
+     * to alter pixels of a frame shared with other branches (copy on write).
+     * @return shared pointer of new video frame.
+     */
+    shared_ptr<VideoFrame> clone() const
+    {
+        return clone(m_format);
+    }
+
+    /**
+     * @brief deep copy of frame with pixels converted to another format (see convertPixels).
+     * @param format(in): pixels format of copy.
+     * @return shared pointer of new video frame.
+     */
+    shared_ptr<VideoFrame> clone(PixelFormat format) const
+    {
+        auto copy = make_shared<VideoFrame>(m_width, m_height, format);
+        copy->convertPixels(*this);
+        copy->m_sequenceNumber = m_sequenceNumber;
+        copy->m_captureTimestamp = m_captureTimestamp;
+        vector<DetectionBox> boxes;
+        m_overlay.snapshot(boxes);
+        for (const auto &box : boxes)
+            copy->m_overlay.add(box);
+        copy->m_groundTruth = m_groundTruth;
+        copy->m_changes = m_changes;
+        return copy;
+    }
+
+    uint32_t m_width; /**< width of frame . */
+    uint32_t m_height; /**< Height of frame . */
+    uint64_t m_sequenceNumber; /**< sequence number of frame in its source (first frame is 0). */
+    FrameClock::time_point m_captureTimestamp; /**< monotonic time of frame capture/generation. */
+    DetectionOverlay m_overlay; /**< detections found in frame. */
+    vector<ObjectPlacement> m_groundTruth; /**< objects placed by a synthetic source, empty otherwise. */
+    FrameChanges m_changes; /**< changed blocks compared to previous frame (see MotionDetectorElement). */
+
+private:
+    /**
+     * @brief deleter of aligned pixels buffer (allocated with aligned operator new).
+     */
+    struct AlignedBufferDeleter
+    {
+        AlignedBufferDeleter() : m_alignment(kRowAlignment) {}
+        explicit AlignedBufferDeleter(size_t alignment) : m_alignment(alignment) {}
+        size_t m_alignment; /**< alignment of buffer. */
+        void operator()(uint8_t *buffer) const
+        {
+            ::operator delete[](buffer, align_val_t(m_alignment));
+        }
+    };
+
+    /**
+     * @brief high bit of each non zero byte of a word.
+     * @param values(in): 8 bytes.
+     * @return uint64_t: 0x80 for non zero bytes, 0 for others.
+     */
+    static uint64_t nonZeroBytes(uint64_t values)
+    {
+        return (((values & 0x7f7f7f7f7f7f7f7full) + 0x7f7f7f7f7f7f7f7full) | values) & 0x8080808080808080ull;
+    }
+
+    /**
+     * @brief gathers high bits of 8 bytes.
+     * @param flags(in): bytes equal to 0x80 or 0.
+     * @return uint64_t: bit k is high bit of byte k.
+     */
+    static uint64_t gatherHighBits(uint64_t flags)
+    {
+        return ((flags >> 7) * 0x0102040810204080ull) >> 56;
+    }
+
+    /**
+     * @brief rounds width up to next multiple of kRowAlignment.
+     * @param width(in): frame width.
+     * @return stride in bytes.
+     */
+    static size_t alignedStride(size_t width)
+    {
+        return ((width + kRowAlignment - 1) / kRowAlignment) * kRowAlignment;
+    }
+
+    /**
+     * @brief allocates zero filled pixels buffer aligned on kRowAlignment.
+     * @param size(in): size in bytes.
+     * @return owning pointer to buffer.
+     */
+    static unique_ptr<uint8_t[], AlignedBufferDeleter> allocatePixels(size_t size, int numaNode)
+    {
+        if (numaNode < 0)
+        {
+            auto buffer = static_cast<uint8_t*>(::operator new[](max<size_t>(size, 1), align_val_t(kRowAlignment)));
+            memset(buffer, 0, size);
+            return unique_ptr<uint8_t[], AlignedBufferDeleter>(buffer);
+        }
+        // whole pages so that policy of node applies to buffer only, zero fill is first touch
+        static const size_t pageSize = max<size_t>(static_cast<size_t>(sysconf(_SC_PAGESIZE)), kRowAlignment);
+        const size_t pagesSize = max<size_t>((size + pageSize - 1) / pageSize, 1) * pageSize;
+        auto buffer = static_cast<uint8_t*>(::operator new[](pagesSize, align_val_t(pageSize)));
+        CpuAffinity::bindToNode(buffer, pagesSize, numaNode);
+        memset(buffer, 0, size);
+        return unique_ptr<uint8_t[], AlignedBufferDeleter>(buffer, AlignedBufferDeleter{pageSize});
+    }
+
+    PixelFormat m_format; /**< pixels format. */
+    size_t m_stride; /**< distance in bytes between two rows. */
+    unique_ptr<uint8_t[], AlignedBufferDeleter> m_buffer; /**< contiguous buffer of height * stride pixels (and match mask), null for a view. */
+    uint8_t *m_pixels; /**< first pixel of frame, in buffer or in memory of a reader. */
+    shared_ptr<void> m_storage; /**< owner of pixels memory of a view. */
+    bool m_matchMaskUsed; /**< true once a pixel of match mask may be flagged. */
+    mutable SummedAreaTable m_summedAreaTable; /**< lazily built summed area table of non zero pixels. */
+};
+
+/**
+ * @brief statistics of frame pool usage, used to size pool for each camera.
+ */
+struct FramePoolStats
+{
+    uint64_t m_hits; /**< number of acquisitions served from free list. */
+    uint64_t m_misses; /**< number of acquisitions which needed a new frame allocation. */
+    size_t m_inUse; /**< number of frames currently acquired and not yet released. */
+    size_t m_free; /**< number of frames currently waiting in free list. */
+    size_t m_highWaterMark; /**< max number of frames in use at same time. */
+};
+
+/**
+ * @brief bounded pool of video frames of same size.
+ * acquired frames are returned as shared pointers, once last shared pointer is dropped
+ * (in any element or thread) frame goes back to free list instead of being freed and
+ * it is reused by next acquisition. Control blocks of shared pointers are recycled too
+ * so that steady state acquire/release cycle does not call allocator at all.
+ * free list keeps at most capacity frames, frames released when free list is full are freed.
+ */
+class FramePool
+{
+public:
+    /**
+     * @brief FramePool constructor.
+     * @param width(in): width of pooled frames.
+     * @param height(in): height of pooled frames.
+     * @param capacity(in): max number of frames kept in free list.
+     * @param format(in): pixels format of pooled frames.
+     * @param numaNode(in): NUMA node of pixels of pooled frames, -1 for node of allocating thread.
+     */
+    FramePool(uint32_t width, uint32_t height, size_t capacity, PixelFormat format = PixelFormat::Gray8, int numaNode = -1) :
+            m_state(make_shared<State>(width, height, capacity, format, numaNode))
+    {
+    }
+
+    /**
+     * @brief gets a frame from free list (hit) or allocates a new one (miss).
+     * pixels content of a reused frame is the one of its previous use, its metadata (overlay, ground truth,
+     * changes, match mask) is cleared.
+     * @return shared pointer of video frame, released to pool with last reference.
+     */
+    shared_ptr<VideoFrame> acquire()
+    {
+        VideoFrame *videoFrame = nullptr;
+        {
+            lock_guard<mutex> lock(m_state->m_lock);
+            if (!m_state->m_freeFrames.empty())
+            {
+                videoFrame = m_state->m_freeFrames.back();
+                m_state->m_freeFrames.pop_back();
+                m_state->m_hits++;
+            }
+            else
+            {
+                m_state->m_misses++;
+            }
+            m_state->m_inUse++;
+            m_state->m_highWaterMark = max(m_state->m_highWaterMark, m_state->m_inUse);
+        }
+
+        if (videoFrame == nullptr)
+        {
+            try
+            {
+                videoFrame = new VideoFrame(m_state->m_width, m_state->m_height, m_state->m_format, m_state->m_numaNode);
+            } catch (...)
+            {
+                lock_guard<mutex> lock(m_state->m_lock);
+                m_state->m_inUse--;
+                throw;
+            }
+        }
+        else
+        {
+            videoFrame->m_overlay.clear();
+            videoFrame->m_groundTruth.clear();
+            videoFrame->m_changes.m_valid = false;
+            videoFrame->clearMatchMask();
+            videoFrame->invalidateSummedAreaTable();
+        }
+
+        return shared_ptr<VideoFrame>(videoFrame, FrameRecycler{m_state}, ControlBlockAllocator<VideoFrame>{m_state});
+    }
+
+    /**
+     * @brief snapshot of pool statistics.
+     * @return FramePoolStats: hits, misses, frames in use, free frames and high water mark.
+     */
+    FramePoolStats stats() const
+    {
+        lock_guard<mutex> lock(m_state->m_lock);
+        return FramePoolStats{m_state->m_hits, m_state->m_misses, m_state->m_inUse,
+                              m_state->m_freeFrames.size(), m_state->m_highWaterMark};
+    }
+
+    /**
+     * @brief max number of frames kept in free list.
+     * @return size_t: capacity.
+     */
+    size_t capacity() const
+    {
+        return m_state->m_capacity;
+    }
+
+    /**
+     * @brief pixels format of pooled frames.
+     * @return PixelFormat.
+     */
+    PixelFormat format() const
+    {
+        return m_state->m_format;
+    }
+
+    /**
+     * @brief NUMA node of pixels of pooled frames.
+     * @return int: node, -1 for node of allocating thread.
+     */
+    int numaNode() const
+    {
+        return m_state->m_numaNode;
+    }
+
+private:
+    static constexpr size_t kControlBlockSize = 128; /**< size of recycled shared pointer control blocks. */
+
+    /**
+     * @brief pool state shared with all acquired frames, so that frames released after
+     * pool destruction still find their free list.
+     */
+    struct State
+    {
+        State(uint32_t width, uint32_t height, size_t capacity, PixelFormat format, int numaNode) :
+                m_width(width), m_height(height), m_capacity(capacity), m_format(format), m_numaNode(numaNode),
+                m_hits(0), m_misses(0), m_inUse(0), m_highWaterMark(0)
+        {
+            m_freeFrames.reserve(capacity);
+            m_freeControlBlocks.reserve(capacity);
+        }
+        ~State()
+        {
+            for_each(m_freeFrames.begin(), m_freeFrames.end(), [](auto videoFrame) { delete videoFrame; });
+            for_each(m_freeControlBlocks.begin(), m_freeControlBlocks.end(), [](auto block) { ::operator delete(block); });
+        }
+        uint32_t m_width; /**< width of pooled frames. */
+        uint32_t m_height; /**< height of pooled frames. */
+        size_t m_capacity; /**< max size of free lists. */
+        PixelFormat m_format; /**< pixels format of pooled frames. */
+        int m_numaNode; /**< NUMA node of pixels of pooled frames. */
+        mutable mutex m_lock; /**< mutex to protect free lists and counters. */
+        vector<VideoFrame*> m_freeFrames; /**< free list of frames. */
+        vector<void*> m_freeControlBlocks; /**< free list of shared pointer control blocks. */
+        uint64_t m_hits; /**< see FramePoolStats. */
+        uint64_t m_misses; /**< see FramePoolStats. */
+        size_t m_inUse; /**< see FramePoolStats. */
+        size_t m_highWaterMark; /**< see FramePoolStats. */
+    };
+
+    /**
+     * @brief shared pointer deleter : gives frame back to free list.
+     */
+    struct FrameRecycler
+    {
+        shared_ptr<State> m_state; /**< owning pool state. */
+        void operator()(VideoFrame *videoFrame) const
+        {
+            unique_lock<mutex> lock(m_state->m_lock);
+            m_state->m_inUse--;
+            if (m_state->m_freeFrames.size() < m_state->m_capacity)
+            {
+                m_state->m_freeFrames.push_back(videoFrame);
+                return;
+            }
+            lock.unlock();
+            delete videoFrame;
+        }
+    };
+
+    /**
+     * @brief allocator used by shared pointer for its control block : blocks are kept in
+     * a free list of the pool state and reused for next acquired frames.
+     */
+    template <typename T>
+    struct ControlBlockAllocator
+    {
+        using value_type = T;
+        shared_ptr<State> m_state; /**< owning pool state. */
+
+        ControlBlockAllocator(shared_ptr<State> state) : m_state(move(state))
+        {
+        }
+        template <typename U>
+        ControlBlockAllocator(const ControlBlockAllocator<U> &other) : m_state(other.m_state)
+        {
+        }
+        T* allocate(size_t count)
+        {
+            if (!isRecyclable(count))
+                return static_cast<T*>(::operator new(count * sizeof(T)));
+            {
+                lock_guard<mutex> lock(m_state->m_lock);
+                if (!m_state->m_freeControlBlocks.empty())
+                {
+                    void *block = m_state->m_freeControlBlocks.back();
+                    m_state->m_freeControlBlocks.pop_back();
+                    return static_cast<T*>(block);
+                }
+            }
+            return static_cast<T*>(::operator new(kControlBlockSize));
+        }
+        void deallocate(T *block, size_t count)
+        {
+            if (isRecyclable(count))
+            {
+                lock_guard<mutex> lock(m_state->m_lock);
+                if (m_state->m_freeControlBlocks.size() < m_state->m_capacity)
+                {
+                    m_state->m_freeControlBlocks.push_back(block);
+                    return;
+                }
+            }
+            ::operator delete(block);
+        }
+        static bool isRecyclable(size_t count)
+        {
+            return ((count * sizeof(T)) <= kControlBlockSize) && (alignof(T) <= alignof(max_align_t));
+        }
+        template <typename U>
+        bool operator==(const ControlBlockAllocator<U> &other) const { return m_state == other.m_state; }
+        template <typename U>
+        bool operator!=(const ControlBlockAllocator<U> &other) const { return m_state != other.m_state; }
+    };
+
+    shared_ptr<State> m_state; /**< pool state shared with acquired frames. */
+};
+
+/**
+ * @brief fixed size pool of worker threads shared by elements for data parallel work.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * @brief ThreadPool constructor : starts worker threads.
+     * @param threads(in): number of worker threads.
+     * @param cpus(in): cores of workers (worker i on cpus[i % size]), empty for no pinning.
+     */
+    ThreadPool(size_t threads, const vector<unsigned> &cpus = {}) : m_runningState(true)
+    {
+        for (size_t i = 0; i < threads; i++)
+        {
+            m_workers.emplace_back(&ThreadPool::workerLoop, this);
+            CpuAffinity::pinOne(m_workers.back().native_handle(), cpus, i);
+        }
+    }
+
+    /**
+     * @brief ThreadPool destructor : runs already submitted tasks then joins workers.
+     */
+    ~ThreadPool()
+    {
+        {
+            lock_guard<mutex> lock(m_tasksLock);
+            m_runningState = false;
+        }
+        m_tasksCv.notify_all();
+        for_each(m_workers.begin(), m_workers.end(), [](auto &worker) { worker.join(); });
+    }
+
+    /**
+     * @brief process wide pool with one worker per core except calling one.
+     * @return ThreadPool: shared pool.
+     */
+    static ThreadPool& shared()
+    {
+        static ThreadPool pool(max(1u, thread::hardware_concurrency()) - 1);
+        return pool;
+    }
+
+    /**
+     * @brief number of worker threads.
+     * @return size_t: workers count.
+     */
+    size_t size() const
+    {
+        return m_workers.size();
+    }
+
+    /**
+     * @brief queues a task executed by first available worker.
+     * @param task(in): task to execute.
+     */
+    void submit(function<void()> task)
+    {
+        {
+            lock_guard<mutex> lock(m_tasksLock);
+            m_tasks.push_back(move(task));
+        }
+        m_tasksCv.notify_one();
+    }
+
+    /**
+     * @brief runs task(i) for each i in [0, count) on workers and calling thread, returns once
+     * all indexes are done. exception thrown by a task is rethrown in calling thread.
+     * @param count(in): number of indexes.
+     * @param task(in): task to run for each index.
+     */
+    void parallelFor(size_t count, const function<void(size_t)> &task)
+    {
+        // batch state is shared with helpers which may start after all indexes are done
+        auto batch = make_shared<Batch>(count, task);
+        for (size_t i = 1; i < min(count, size() + 1); i++)
+            submit([batch] { batch->run(); });
+        batch->run();
+
+        unique_lock<mutex> lock(batch->m_lock);
+        batch->m_doneCv.wait(lock, [&batch] { return batch->m_remaining == 0; });
+        if (batch->m_error)
+            rethrow_exception(batch->m_error);
+    }
+
+private:
+    /**
+     * @brief indexes of a parallelFor shared between threads.
+     */
+    struct Batch
+    {
+        Batch(size_t count, const function<void(size_t)> &task) :
+                m_task(task), m_count(count), m_next(0), m_remaining(count)
+        {
+        }
+        void run()
+        {
+            for (size_t i = m_next++; i < m_count; i = m_next++)
+            {
+                try
+                {
+                    m_task(i);
+                } catch (...)
+                {
+                    lock_guard<mutex> lock(m_lock);
+                    m_error = current_exception();
+                }
+                lock_guard<mutex> lock(m_lock);
+                if (--m_remaining == 0)
+                    m_doneCv.notify_all();
+            }
+        }
+        const function<void(size_t)> &m_task; /**< task, alive until all indexes are done. */
+        size_t m_count; /**< number of indexes. */
+        atomic<size_t> m_next; /**< next index to run. */
+        size_t m_remaining; /**< indexes not done yet. */
+        exception_ptr m_error; /**< exception thrown by a task. */
+        mutex m_lock; /**< protects remaining and error. */
+        condition_variable m_doneCv; /**< notified when all indexes are done. */
+    };
+
+    /**
+     * @brief method executed by worker threads : runs queued tasks until pool destruction.
+     */
+    void workerLoop(void)
+    {
+        unique_lock<mutex> lock(m_tasksLock);
+        while (true)
+        {
+            m_tasksCv.wait(lock, [this] { return !m_tasks.empty() || !m_runningState; });
+            if (m_tasks.empty())
+                return;
+            auto task = move(m_tasks.front());
+            m_tasks.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    }
+
+    vector<thread> m_workers; /**< worker threads. */
+    deque<function<void()>> m_tasks; /**< queued tasks. */
+    mutex m_tasksLock; /**< protects tasks and running state. */
+    condition_variable m_tasksCv; /**< notified when a task is queued or pool is destroyed. */
+    bool m_runningState; /**< false once pool is being destroyed. */
+};
+
+/**
+ * @brief executor of pipeline tasks on a fixed number of workers (by default one per core) whatever
+ * number of pipelines : elements submit short tasks (forward queued frames, generate next frame)
+ * instead of owning a sleeping thread each.
+ * each worker owns a deque of tasks : tasks submitted from a worker go to its own deque and are
+ * popped LIFO (cache hot), other tasks are spread round robin, an idle worker steals oldest task
+ * of other deques before parking. delayed tasks are kept by a timer thread which submits them at
+ * their deadline.
+ * executor must outlive elements using it, pending delayed tasks are dropped at destruction.
+ */
+class PipelineExecutor
+{
+public:
+    /**
+     * @brief PipelineExecutor constructor : starts workers and timer thread.
+     * @param workers(in): number of worker threads (0 : one per core, or per core of cpus).
+     * @param cpus(in): cores of workers (worker i on cpus[i % size], timer thread on all of them), empty
+     * for no pinning.
+     */
+    PipelineExecutor(size_t workers = 0, const vector<unsigned> &cpus = {}) :
+            m_pendingTasks(0), m_nextWorker(0), m_runningState(true), m_timerSequence(0)
+    {
+        const size_t count = workers ? workers : (cpus.empty() ? max(1u, thread::hardware_concurrency()) : cpus.size());
+        for (size_t i = 0; i < count; i++)
+            m_workers.push_back(make_unique<Worker>());
+        for (size_t i = 0; i < count; i++)
+        {
+            m_threads.emplace_back(&PipelineExecutor::workerLoop, this, i);
+            CpuAffinity::pinOne(m_threads.back().native_handle(), cpus, i);
+        }
+        m_timerThread = thread(&PipelineExecutor::timerLoop, this);
+        CpuAffinity::pin(m_timerThread.native_handle(), cpus);
+    }
+
+    /**
+     * @brief PipelineExecutor destructor : drops delayed tasks, runs already submitted tasks then joins workers.
+     */
+    ~PipelineExecutor()
+    {
+        {
+            lock_guard<mutex> lock(m_timerLock);
+            m_runningState = false;
+        }
+        m_timerCv.notify_all();
+        m_timerThread.join();
+        {
+            lock_guard<mutex> lock(m_idleLock);
+        }
+        m_idleCv.notify_all();
+        for_each(m_threads.begin(), m_threads.end(), [](auto &worker) { worker.join(); });
+    }
+
+    /**
+     * @brief number of worker threads.
+     * @return size_t: workers count.
+     */
+    size_t size() const
+    {
+        return m_workers.size();
+    }
+
+    /**
+     * @brief queues a task executed as soon as a worker is available.
+     * exception thrown by a task is logged and does not stop executor.
+     * @param task(in): task to execute.
+     */
+    void submit(function<void()> task)
+    {
+        const WorkerIdentity &current = currentWorker();
+        const size_t index = (current.m_executor == this) ? current.m_index :
+                             (m_nextWorker.fetch_add(1, memory_order_relaxed) % m_workers.size());
+        {
+            lock_guard<mutex> lock(m_workers[index]->m_lock);
+            m_workers[index]->m_tasks.push_back(move(task));
+        }
+        m_pendingTasks.fetch_add(1);
+        {
+            // pairs with predicate check of parking workers so that wakeup cannot be lost
+            lock_guard<mutex> lock(m_idleLock);
+        }
+        m_idleCv.notify_one();
+    }
+
+    /**
+     * @brief queues a task behind all tasks already queued by current worker (owner runs newest
+     * tasks first) : activity rescheduling itself (unthrottled source, queue with frames left)
+     * yields its worker to other activities instead of monopolizing it.
+     * @param task(in): task to execute.
+     */
+    void yield(function<void()> task)
+    {
+        const WorkerIdentity &current = currentWorker();
+        if (current.m_executor != this)
+        {
+            submit(move(task));
+            return;
+        }
+        {
+            lock_guard<mutex> lock(m_workers[current.m_index]->m_lock);
+            m_workers[current.m_index]->m_tasks.push_front(move(task));
+        }
+        m_pendingTasks.fetch_add(1);
+        {
+            lock_guard<mutex> lock(m_idleLock);
+        }
+        m_idleCv.notify_one();
+    }
+
+    /**
+     * @brief queues a task executed once deadline is reached.
+     * @param deadline(in): earliest time of execution.
+     * @param task(in): task to execute.
+     */
+    void submitAt(FrameClock::time_point deadline, function<void()> task)
+    {
+        {
+            lock_guard<mutex> lock(m_timerLock);
+            m_timers.push(TimerTask{deadline, m_timerSequence++, move(task)});
+        }
+        m_timerCv.notify_one();
+    }
+
+private:
+    /**
+     * @brief tasks deque of one worker.
+     */
+    struct Worker
+    {
+        mutex m_lock; /**< protects tasks. */
+        deque<function<void()>> m_tasks; /**< tasks of worker, owner pops back, thieves pop front. */
+    };
+
+    /**
+     * @brief delayed task, ordered by deadline then by submission.
+     */
+    struct TimerTask
+    {
+        FrameClock::time_point m_deadline; /**< earliest time of execution. */
+        uint64_t m_sequence; /**< submission order of tasks with same deadline. */
+        function<void()> m_task; /**< task to execute. */
+        bool operator>(const TimerTask &other) const
+        {
+            return (m_deadline > other.m_deadline) || ((m_deadline == other.m_deadline) && (m_sequence > other.m_sequence));
+        }
+    };
+
+    /**
+     * @brief identity of worker running on current thread.
+     */
+    struct WorkerIdentity
+    {
+        PipelineExecutor *m_executor; /**< executor of worker, null out of workers. */
+        size_t m_index; /**< index of worker in its executor. */
+    };
+
+    static WorkerIdentity& currentWorker()
+    {
+        static thread_local WorkerIdentity identity{nullptr, 0};
+        return identity;
+    }
+
+    /**
+     * @brief gets next task of worker : newest of its own deque, else oldest of another deque.
+     * @param index(in): worker index.
+     * @param task(out): task to run.
+     * @return bool: false when all deques are empty.
+     */
+    bool popTask(size_t index, function<void()> &task)
+    {
+        {
+            Worker &worker = *m_workers[index];
+            lock_guard<mutex> lock(worker.m_lock);
+            if (!worker.m_tasks.empty())
+            {
+                task = move(worker.m_tasks.back());
+                worker.m_tasks.pop_back();
+                return true;
+            }
+        }
+        for (size_t i = 1; i < m_workers.size(); i++)
+        {
+            Worker &victim = *m_workers[(index + i) % m_workers.size()];
+            lock_guard<mutex> lock(victim.m_lock);
+            if (!victim.m_tasks.empty())
+            {
+                task = move(victim.m_tasks.front());
+                victim.m_tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief method executed by worker threads : runs tasks, parks when there is none,
+     * until executor destruction.
+     * @param index(in): worker index.
+     */
+    void workerLoop(size_t index)
+    {
+        currentWorker() = WorkerIdentity{this, index};
+        function<void()> task;
+        while (true)
+        {
+            if (popTask(index, task))
+            {
+                m_pendingTasks.fetch_sub(1);
+                try
+                {
+                    task();
+                } catch (const exception &e)
+                {
+                    MD_LOG(LogLevel::Info, "PipelineExecutor task failed : " << e.what() << "\n");
+                }
+                task = nullptr;
+                continue;
+            }
+
+            unique_lock<mutex> lock(m_idleLock);
+            m_idleCv.wait(lock, [this] { return (m_pendingTasks.load() > 0) || !m_runningState; });
+            if ((m_pendingTasks.load() <= 0) && !m_runningState)
+                return;
+        }
+    }
+
+    /**
+     * @brief method executed by timer thread : submits delayed tasks at their deadline.
+     */
+    void timerLoop(void)
+    {
+        unique_lock<mutex> lock(m_timerLock);
+        while (m_runningState)
+        {
+            if (m_timers.empty())
+            {
+                m_timerCv.wait(lock);
+                continue;
+            }
+            // copied : timers heap may grow (and move) while waiting
+            const FrameClock::time_point deadline = m_timers.top().m_deadline;
+            if (FrameClock::now() < deadline)
+            {
+                m_timerCv.wait_until(lock, deadline);
+                continue;
+            }
+            auto task = move(const_cast<TimerTask&>(m_timers.top()).m_task);
+            m_timers.pop();
+            lock.unlock();
+            submit(move(task));
+            lock.lock();
+        }
+    }
+
+    vector<unique_ptr<Worker>> m_workers; /**< deques of workers. */
+    vector<thread> m_threads; /**< worker threads. */
+    thread m_timerThread; /**< thread submitting delayed tasks. */
+    atomic<int64_t> m_pendingTasks; /**< number of tasks queued in deques (may be transiently negative). */
+    atomic<size_t> m_nextWorker; /**< round robin index of tasks submitted out of workers. */
+    mutex m_idleLock; /**< mutex of parked workers. */
+    condition_variable m_idleCv; /**< notified when a task is queued or executor is destroyed. */
+    atomic<bool> m_runningState; /**< false once executor is being destroyed. */
+    mutex m_timerLock; /**< protects delayed tasks. */
+    condition_variable m_timerCv; /**< notified when a delayed task is queued or executor is destroyed. */
+    priority_queue<TimerTask, vector<TimerTask>, greater<TimerTask>> m_timers; /**< delayed tasks, earliest first. */
+    uint64_t m_timerSequence; /**< submission counter of delayed tasks. */
+};
+
+/**
+ * @brief non owning view of consecutive frames processed as one batch.
+ */
+class FrameSpan
+{
+public:
+    /**
+     * @brief FrameSpan constructor.
+     * @param data(in): pointer to first frame of batch.
+     * @param size(in): number of frames in batch.
+     */
+    FrameSpan(const shared_ptr<VideoFrame> *data, size_t size) : m_data(data), m_size(size)
+    {
+    }
+    /**
+     * @brief FrameSpan constructor viewing all frames of a vector.
+     * @param frames(in): frames of batch.
+     */
+    FrameSpan(const vector<shared_ptr<VideoFrame>> &frames) : FrameSpan(frames.data(), frames.size())
+    {
+    }
+    const shared_ptr<VideoFrame>* begin() const { return m_data; }
+    const shared_ptr<VideoFrame>* end() const { return m_data + m_size; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    const shared_ptr<VideoFrame>& operator[](size_t index) const { return m_data[index]; }
+private:
+    const shared_ptr<VideoFrame> *m_data; /**< first frame of batch. */
+    size_t m_size; /**< number of frames in batch. */
+};
+
+/**
+ * @brief snapshot of counters of an element (see ElementCounters), times in nanoseconds.
+ */
+struct ElementStats
+{
+    string m_name; /**< name of element given to StatsReporter, empty otherwise. */
+    uint64_t m_framesIn = 0; /**< frames processed (generated frames for a source). */
+    uint64_t m_framesOut = 0; /**< frames pushed to next elements. */
+    uint64_t m_processTime = 0; /**< total time in process (push time for an asynchronous queue). */
+    uint64_t m_maxProcessTime = 0; /**< max time in process of one frame or batch since previous peaks reset. */
+    uint64_t m_latency = 0; /**< total latency from capture timestamp to end of process of frames. */
+    uint64_t m_maxLatency = 0; /**< max latency of a frame since previous peaks reset. */
+    bool m_queue = false; /**< element is a queue, fields below are valid. */
+    size_t m_queueDepth = 0; /**< frames currently queued. */
+    uint64_t m_dropped = 0; /**< frames dropped by queue (all backpressure policies). */
+};
+
+/**
+ * @brief counters of an element updated where frames are dispatched to it (see dispatchFrame), any
+ * thread may update them. instrumentation is process wide and disabled by default, so that
+ * dispatch reads no clock unless it is enabled.
+ */
+class ElementCounters
+{
+public:
+    /**
+     * @brief enables or disables instrumentation of all elements.
+     * @param enabled(in): true to update counters.
+     */
+    static void setEnabled(bool enabled)
+    {
+        enabledFlag().store(enabled, memory_order_relaxed);
+    }
+
+    /**
+     * @brief checks if instrumentation is enabled.
+     * @return bool.
+     */
+    static bool isEnabled()
+    {
+        return enabledFlag().load(memory_order_relaxed);
+    }
+
+    /**
+     * @brief records processing of frames.
+     * @param frames(in): number of processed frames.
+     * @param processTime(in): time spent in process.
+     */
+    void recordProcess(size_t frames, FrameClock::duration processTime)
+    {
+        const uint64_t nanoseconds = chrono::duration_cast<chrono::nanoseconds>(processTime).count();
+        m_framesIn.fetch_add(frames, memory_order_relaxed);
+        m_processTime.fetch_add(nanoseconds, memory_order_relaxed);
+        updateMax(m_maxProcessTime, nanoseconds);
+    }
+
+    /**
+     * @brief records latency of a processed frame.
+     * @param videoFrame(in): frame, latency is counted from its capture timestamp.
+     * @param now(in): end of processing of frame.
+     */
+    void recordLatency(const VideoFrame &videoFrame, FrameClock::time_point now)
+    {
+        const uint64_t nanoseconds = chrono::duration_cast<chrono::nanoseconds>(now - videoFrame.m_captureTimestamp).count();
+        m_latency.fetch_add(nanoseconds, memory_order_relaxed);
+        updateMax(m_maxLatency, nanoseconds);
+    }
+
+    /**
+     * @brief records frames pushed to next elements.
+     * @param frames(in): number of frames.
+     */
+    void recordOutput(size_t frames)
+    {
+        m_framesOut.fetch_add(frames, memory_order_relaxed);
+    }
+
+    /**
+     * @brief current values of counters.
+     * @param resetPeaks(in): max values are reset (for instance once per periodic dump).
+     * @return ElementStats: counters (queue fields left empty).
+     */
+    ElementStats snapshot(bool resetPeaks)
+    {
+        ElementStats stats;
+        stats.m_framesIn = m_framesIn.load(memory_order_relaxed);
+        stats.m_framesOut = m_framesOut.load(memory_order_relaxed);
+        stats.m_processTime = m_processTime.load(memory_order_relaxed);
+        stats.m_latency = m_latency.load(memory_order_relaxed);
+        stats.m_maxProcessTime = resetPeaks ? m_maxProcessTime.exchange(0, memory_order_relaxed) : m_maxProcessTime.load(memory_order_relaxed);
+        stats.m_maxLatency = resetPeaks ? m_maxLatency.exchange(0, memory_order_relaxed) : m_maxLatency.load(memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    static atomic<bool>& enabledFlag()
+    {
+        static atomic<bool> enabled(false);
+        return enabled;
+    }
+
+    static void updateMax(atomic<uint64_t> &maximum, uint64_t value)
+    {
+        uint64_t current = maximum.load(memory_order_relaxed);
+        while ((value > current) && !maximum.compare_exchange_weak(current, value, memory_order_relaxed))
+        {
+        }
+    }
+
+    atomic<uint64_t> m_framesIn{0}; /**< see ElementStats. */
+    atomic<uint64_t> m_framesOut{0}; /**< see ElementStats. */
+    atomic<uint64_t> m_processTime{0}; /**< see ElementStats. */
+    atomic<uint64_t> m_maxProcessTime{0}; /**< see ElementStats. */
+    atomic<uint64_t> m_latency{0}; /**< see ElementStats. */
+    atomic<uint64_t> m_maxLatency{0}; /**< see ElementStats. */
+};
+
+/**
+ * @brief virtual class to define all common methods (pure virtual) to be able to create pipeline between elements.
+ */
+class Element
+{
+public:
+    /**
+     * @brief pure virtual method to link element.
+     * @param element(in): output element to link.
+     * @return element(out): pointer to linked element.
+     */
+    virtual Element* link(Element *element) = 0;
+    /**
+     * @brief pure virtual method to process frame.
+     * @param videoFrame(in): shared pointer of video frame.
+     * @return void.
+     */
+    virtual void process(shared_ptr<VideoFrame> videoFrame) = 0;
+    /**
+     * @brief pure virtual method to process frame and forward video frame handling to next element.
+     * @param videoFrame(in): shared pointer of video frame.
+     * @return void.
+     */
+    virtual void processAndPushDownstream(shared_ptr<VideoFrame> videoFrame) = 0;
+    /**
+     * @brief pure virtual method to process a batch of frames (oldest first).
+     * @param videoFrames(in): frames of batch.
+     * @return void.
+     */
+    virtual void processBatch(FrameSpan videoFrames) = 0;
+    /**
+     * @brief pure virtual method to process a batch of frames and forward batch handling to next element.
+     * @param videoFrames(in): frames of batch.
+     * @return void.
+     */
+    virtual void processBatchAndPushDownstream(FrameSpan videoFrames) = 0;
+    /**
+     * @brief pure virtual method to access counters of element updated by dispatch of frames.
+     * @return ElementCounters: counters of element.
+     */
+    virtual ElementCounters& counters() = 0;
+    /**
+     * @brief pure virtual method to snapshot statistics of element.
+     * @param resetPeaks(in): max values are reset.
+     * @return ElementStats: statistics (name left empty).
+     */
+    virtual ElementStats elementStats(bool resetPeaks) = 0;
+};
+
+/**
+ * @brief calls process then processAndPushDownstream of an element for a frame, counting frames, time
+ * in process and latency of frame when instrumentation is enabled. used by every element pushing frames
+ * downstream.
+ * @param element(in): next element.
+ * @param videoFrame(in): shared pointer of video frame.
+ */
+inline void dispatchFrame(Element *element, const shared_ptr<VideoFrame> &videoFrame)
+{
+    if (!ElementCounters::isEnabled())
+    {
+        element->process(videoFrame);
+        element->processAndPushDownstream(videoFrame);
+        return;
+    }
+    const auto start = FrameClock::now();
+    element->process(videoFrame);
+    const auto end = FrameClock::now();
+    ElementCounters &counters = element->counters();
+    counters.recordProcess(1, end - start);
+    counters.recordLatency(*videoFrame, end);
+    element->processAndPushDownstream(videoFrame);
+}
+
+/**
+ * @brief same as dispatchFrame for a batch (processBatch then processBatchAndPushDownstream).
+ * @param element(in): next element.
+ * @param videoFrames(in): frames of batch.
+ */
+inline void dispatchBatch(Element *element, FrameSpan videoFrames)
+{
+    if (!ElementCounters::isEnabled())
+    {
+        element->processBatch(videoFrames);
+        element->processBatchAndPushDownstream(videoFrames);
+        return;
+    }
+    const auto start = FrameClock::now();
+    element->processBatch(videoFrames);
+    const auto end = FrameClock::now();
+    ElementCounters &counters = element->counters();
+    counters.recordProcess(videoFrames.size(), end - start);
+    for (const auto &videoFrame : videoFrames)
+        counters.recordLatency(*videoFrame, end);
+    element->processBatchAndPushDownstream(videoFrames);
+}
+
+/**
+ * @brief base class for all elements of pipeline with implementation of generic methods (link, processAndPushDownstream).
+ */
+class BaseElement: public Element
+{
+private:
+    vector<Element*> m_nextElements; /**< vector to store all next elements in pipeline. */
+    ElementCounters m_counters; /**< counters of element (see dispatchFrame). */
+
+public:
+    /**
+     * @brief BaseElement constructor.
+     */
+    BaseElement() : m_nextElements{}
+    {
+    }
+    /**
+     * @brief BaseElement destructor.
+     */
+    virtual ~BaseElement() = default;
+
+    /**
+     * @brief implementation of link method. any new element to linked is pushed in internal vector.
+     * @param element(in): output element to link.
+     * @return element(out): pointer to linked element.
+     */
+    Element* link(Element *element) override
+    {
+        m_nextElements.push_back(element);
+        return element;
+    }
+
+    /**
+     * @brief implementation of processAndPushDownstream method.It loops in vector of next element to call
+     * process method of any next element and then call processAndPushDownstream method.
+     * @param videoFrame(in): shared pointer of video frame.
+     * @return void.
+     */
+    virtual void processAndPushDownstream(shared_ptr<VideoFrame> videoFrame) override
+    {
+        if (!m_nextElements.empty() && ElementCounters::isEnabled())
+            m_counters.recordOutput(1);
+        for_each(m_nextElements.cbegin(), m_nextElements.cend(), [&videoFrame](const auto &element) {
+            dispatchFrame(element, videoFrame);
+        });
+    }
+
+    /**
+     * @brief default implementation of processBatch method for elements without batch support :
+     * it calls process method for each frame of batch.
+     * @param videoFrames(in): frames of batch.
+     * @return void.
+     */
+    virtual void processBatch(FrameSpan videoFrames) override
+    {
+        for (const auto &videoFrame : videoFrames)
+            process(videoFrame);
+    }
+
+    /**
+     * @brief implementation of processBatchAndPushDownstream method. same as processAndPushDownstream
+     * for a whole batch : each next element processes whole batch before next one.
+     * @param videoFrames(in): frames of batch.
+     * @return void.
+     */
+    virtual void processBatchAndPushDownstream(FrameSpan videoFrames) override
+    {
+        if (!m_nextElements.empty() && ElementCounters::isEnabled())
+            m_counters.recordOutput(videoFrames.size());
+        for_each(m_nextElements.cbegin(), m_nextElements.cend(), [&videoFrames](const auto &element) {
+            dispatchBatch(element, videoFrames);
+        });
+    }
+
+    /**
+     * @brief implementation of counters method.
+     * @return ElementCounters: counters of element.
+     */
+    ElementCounters& counters() override
+    {
+        return m_counters;
+    }
+
+    /**
+     * @brief implementation of elementStats method : snapshot of counters of element.
+     * @param resetPeaks(in): max values are reset.
+     * @return ElementStats: statistics.
+     */
+    virtual ElementStats elementStats(bool resetPeaks) override
+    {
+        return m_counters.snapshot(resetPeaks);
+    }
+
+    friend class AsynchronousQueue; /**<  for AsynchronousQueue we have to reimplement some methods and access to private
+                                          members of private BasicElement members class. */
+};
+
+/**
+ * @brief xoshiro256** pseudo random generator (Blackman and Vigna) : 256 bits state, 64 bits output
+ * per call for a few cycles, state seeded from one 64 bits value with splitmix64. not suitable for
+ * cryptography, used to generate synthetic frames.
+ */
+class Xoshiro256StarStar
+{
+public:
+    /**
+     * @brief Xoshiro256StarStar constructor.
+     * @param seed(in): seed, same seed gives same sequence.
+     */
+    Xoshiro256StarStar(uint64_t seed)
+    {
+        this->seed(seed);
+    }
+
+    /**
+     * @brief restarts sequence from a seed.
+     * @param seed(in): seed.
+     */
+    void seed(uint64_t seed)
+    {
+        for (auto &word : m_state)
+        {
+            // splitmix64
+            seed += 0x9e3779b97f4a7c15ull;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    /**
+     * @brief next 64 random bits.
+     * @return uint64_t.
+     */
+    uint64_t operator()()
+    {
+        const uint64_t result = rotl(m_state[1] * 5, 7) * 9;
+        const uint64_t t = m_state[1] << 17;
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotl(m_state[3], 45);
+        return result;
+    }
+
+private:
+    static uint64_t rotl(uint64_t x, int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    array<uint64_t, 4> m_state; /**< generator state. */
+};
+
+/**
+ * @brief fills a row with random pixels in {0, 1} : each 64 bits word of generator gives 64 pixels
+ * (pixel j of a block is bit j of word) expanded 8 pixels at a time with kBitsToPixels.
+ * @param row(in/out): pixels to fill.
+ * @param generator(in/out): random generator.
+ */
+inline void fillRandomBits(PixelRow<uint8_t> row, Xoshiro256StarStar &generator)
+{
+    uint8_t *pixels = row.data();
+    size_t remaining = row.size();
+    while (remaining >= 64)
+    {
+        uint64_t word = generator();
+        for (size_t k = 0; k < 64; k += 8, word >>= 8)
+            memcpy(pixels + k, kBitsToPixels[word & 0xff].data(), 8);
+        pixels += 64;
+        remaining -= 64;
+    }
+    for (uint64_t word = generator(); remaining > 0; remaining--, word >>= 1)
+        *pixels++ = word & 1;
+}
+
+/**
+ * @brief fills a row of Mono1 frame with random pixels in {0, 1} : same generator words as for a
+ * byte row (see fillRandomBits above) written as they are, so that same seed gives same frames
+ * in both formats.
+ * @param words(in/out): words of row to fill.
+ * @param width(in): pixels of row.
+ * @param generator(in/out): random generator.
+ */
+inline void fillRandomBits(uint64_t *words, size_t width, Xoshiro256StarStar &generator)
+{
+    size_t word = 0;
+    for (; (word + 1) * 64 <= width; word++)
+        words[word] = generator();
+    const uint64_t last = generator();
+    if (word * 64 < width)
+        words[word] = last & bitRangeMask(word, 0, width);
+}
+
+/**
+ * @brief fills a row with random pixels, each pixel being 1 with a given probability (8 pixels per
+ * 64 bits word, probability resolution is 1/256).
+ * @param row(in/out): pixels to fill.
+ * @param generator(in/out): random generator.
+ * @param density(in): probability of 1 pixels in [0, 1].
+ */
+inline void fillRandomPixels(PixelRow<uint8_t> row, Xoshiro256StarStar &generator, double density)
+{
+    if (density == 0.5)
+    {
+        fillRandomBits(row, generator);
+        return;
+    }
+    const uint32_t threshold = static_cast<uint32_t>(lround(min(max(density, 0.0), 1.0) * 256));
+    uint64_t word = 0;
+    for (size_t x = 0; x < row.size(); x++, word >>= 8)
+    {
+        if ((x % 8) == 0)
+            word = generator();
+        row[x] = (word & 0xff) < threshold;
+    }
+}
+
+/**
+ * @brief interface of pixels generators of VideoSourceElement.
+ */
+class FrameGenerator
+{
+public:
+    virtual ~FrameGenerator() = default;
+    /**
+     * @brief fills pixels (and metadata such as ground truth) of next frame.
+     * @param frame(in/out): frame to fill, pixels content is the one of a previous frame.
+     */
+    virtual void generate(VideoFrame &frame) = 0;
+
+    /**
+     * @brief checks if generator writes pixels of a format, VideoSourceElement converts frames of
+     * generators writing only Gray8 pixels.
+     * @param format(in): pixels format.
+     * @return bool: true if frames of format can be given to generate.
+     */
+    virtual bool generates(PixelFormat format) const
+    {
+        return format == PixelFormat::Gray8;
+    }
+
+    /**
+     * @brief next frame as a view of memory of generator (zero copy, see VideoFrame view constructor),
+     * used by VideoSourceElement instead of generate when not null.
+     * @return shared pointer of Gray8 frame view, null for a generator filling frames of source pool.
+     */
+    virtual shared_ptr<VideoFrame> generateView()
+    {
+        return nullptr;
+    }
+
+    /**
+     * @brief checks end of frames of a recorded stream, VideoSourceElement stops once generator is
+     * exhausted (frame given to last generate is not pushed).
+     * @return bool: true once generator has no more frames.
+     */
+    virtual bool exhausted() const
+    {
+        return false;
+    }
+};
+
+/**
+ * @brief generator of independent noise frames : each pixel is 0 or 1 with same probability.
+ */
+class NoiseFrameGenerator: public FrameGenerator
+{
+public:
+    /**
+     * @brief NoiseFrameGenerator constructor.
+     * @param seed(in): seed, same seed gives same frames.
+     */
+    NoiseFrameGenerator(uint64_t seed) : m_randomGenerator(seed)
+    {
+    }
+
+    void generate(VideoFrame &frame) override
+    {
+        for (size_t i = 0; i < frame.m_height; i++)
+        {
+            if (frame.format() == PixelFormat::Mono1)
+                fillRandomBits(frame.bits(i), frame.m_width, m_randomGenerator);
+            else
+                fillRandomBits(frame.row(i), m_randomGenerator);
+        }
+    }
+
+    bool generates(PixelFormat) const override
+    {
+        return true;
+    }
+
+private:
+    Xoshiro256StarStar m_randomGenerator; /**< generator of pixels. */
+};
+
+/**
+ * @brief options of synthetic motion sequence (see MovingObjectsFrameGenerator).
+ */
+struct MotionSceneConfig
+{
+    uint64_t m_seed = 0; /**< seed, same seed and options give same frames. */
+    size_t m_objectCount = 1; /**< number of moving objects. */
+    vector<vector<vector<uint8_t>>> m_shapes; /**< shapes of objects (object i has shape i modulo shapes count), non empty. */
+    double m_minSpeed = 0.5; /**< min speed of objects in pixels per frame. */
+    double m_maxSpeed = 2; /**< max speed of objects in pixels per frame. */
+    double m_density = 0.1; /**< probability of 1 pixels in background. */
+    double m_noise = 0; /**< probability of flipping a pixel of an object. */
+    bool m_staticBackground = false; /**< background generated once (mostly static scene) instead of for each frame. */
+};
+
+/**
+ * @brief generator of motion sequences : objects of given shapes (for instance pattern to detect)
+ * move at constant velocity across frames, bouncing on frame borders, over a random background
+ * regenerated for each frame (or generated once for a static background). object rectangle (zeros of shape included) overwrites background,
+ * objects are drawn in order so that a later object may hide an earlier one.
+ * frames are deterministic from seed. positions of objects are recorded in frame ground truth.
+ * with a static background, only previous and new rectangles of objects change from one frame to
+ * next one : they are declared in frame changes (no need to compare frames).
+ * objects larger than frame are not drawn.
+ */
+class MovingObjectsFrameGenerator: public FrameGenerator
+{
+public:
+    /**
+     * @brief MovingObjectsFrameGenerator constructor, throws invalid_argument for inconsistent options.
+     * @param config(in): scene options.
+     */
+    MovingObjectsFrameGenerator(const MotionSceneConfig &config) :
+            m_config(config), m_randomGenerator(config.m_seed), m_placed(false), m_previousSequence(0)
+    {
+        if (config.m_shapes.empty())
+            throw invalid_argument("MovingObjectsFrameGenerator needs at least one shape");
+        for (const auto &shape : config.m_shapes)
+            if (shape.empty() || shape[0].empty())
+                throw invalid_argument("MovingObjectsFrameGenerator shape is empty");
+        if ((config.m_minSpeed < 0) || (config.m_maxSpeed < config.m_minSpeed))
+            throw invalid_argument("MovingObjectsFrameGenerator speeds must satisfy 0 <= min <= max");
+    }
+
+    void generate(VideoFrame &frame) override
+    {
+        const bool declareChanges = m_config.m_staticBackground && m_placed && (frame.m_sequenceNumber == m_previousSequence + 1) &&
+                                    (m_background.size() == size_t(frame.m_width) * frame.m_height);
+        if (declareChanges)
+        {
+            frame.m_changes.reset(frame.m_width, frame.m_height, FrameChanges::kDefaultBlockWidth, FrameChanges::kDefaultBlockHeight,
+                                  m_previousSequence);
+            for (const auto &placement : m_previousPlacements)
+                frame.m_changes.addDirtyRegion(placement.m_box);
+        }
+        else
+        {
+            frame.m_changes.m_valid = false;
+        }
+
+        if (!m_placed)
+            placeObjects(frame);
+        else
+            moveObjects(frame);
+
+        if (m_config.m_staticBackground)
+        {
+            if (m_background.size() != size_t(frame.m_width) * frame.m_height)
+            {
+                m_background.resize(size_t(frame.m_width) * frame.m_height);
+                for (size_t i = 0; i < frame.m_height; i++)
+                    fillRandomPixels(PixelRow<uint8_t>(m_background.data() + i * frame.m_width, frame.m_width), m_randomGenerator, m_config.m_density);
+            }
+            for (size_t i = 0; i < frame.m_height; i++)
+                memcpy(frame.row(i).data(), m_background.data() + i * frame.m_width, frame.m_width);
+        }
+        else
+        {
+            for (size_t i = 0; i < frame.m_height; i++)
+            {
+                fillRandomPixels(frame.row(i), m_randomGenerator, m_config.m_density);
+            }
+        }
+
+        frame.m_groundTruth.clear();
+        for (size_t id = 0; id < m_objects.size(); id++)
+        {
+            const auto &object = m_objects[id];
+            const auto &shape = m_config.m_shapes[object.m_shapeId];
+            if ((shape.size() > frame.m_height) || (shape[0].size() > frame.m_width))
+                continue;
+            const auto x = static_cast<uint32_t>(lround(object.m_x));
+            const auto y = static_cast<uint32_t>(lround(object.m_y));
+            for (size_t k = 0; k < shape.size(); k++)
+            {
+                auto row = frame.row(y + k);
+                for (size_t l = 0; l < shape[k].size(); l++)
+                    row[x + l] = (m_config.m_noise > 0) && (uniform() < m_config.m_noise) ? !shape[k][l] : shape[k][l];
+            }
+            frame.m_groundTruth.push_back(ObjectPlacement{id, object.m_shapeId,
+                    DetectionBox{x, y, static_cast<uint32_t>(shape[0].size()), static_cast<uint32_t>(shape.size())}});
+            if (declareChanges)
+                frame.m_changes.addDirtyRegion(frame.m_groundTruth.back().m_box);
+        }
+        m_previousSequence = frame.m_sequenceNumber;
+        m_previousPlacements = frame.m_groundTruth;
+    }
+
+private:
+    /**
+     * @brief position and velocity of an object (pixels, pixels per frame).
+     */
+    struct MovingObject
+    {
+        size_t m_shapeId; /**< index of shape. */
+        double m_x; /**< column of top left corner. */
+        double m_y; /**< row of top left corner. */
+        double m_velocityX; /**< columns per frame. */
+        double m_velocityY; /**< rows per frame. */
+    };
+
+    /**
+     * @brief uniform random value in [0, 1).
+     * @return double.
+     */
+    double uniform()
+    {
+        return static_cast<double>(m_randomGenerator() >> 11) * 0x1.0p-53;
+    }
+
+    /**
+     * @brief chooses random positions and velocities of objects (first frame).
+     * @param frame(in): first frame.
+     */
+    void placeObjects(const VideoFrame &frame)
+    {
+        const double pi = acos(-1.0);
+        for (size_t id = 0; id < m_config.m_objectCount; id++)
+        {
+            const size_t shapeId = id % m_config.m_shapes.size();
+            const auto &shape = m_config.m_shapes[shapeId];
+            const double rangeX = max(0.0, double(frame.m_width) - double(shape[0].size()));
+            const double rangeY = max(0.0, double(frame.m_height) - double(shape.size()));
+            const double speed = m_config.m_minSpeed + uniform() * (m_config.m_maxSpeed - m_config.m_minSpeed);
+            const double angle = 2 * pi * uniform();
+            m_objects.push_back(MovingObject{shapeId, uniform() * rangeX, uniform() * rangeY,
+                                             speed * cos(angle), speed * sin(angle)});
+        }
+        m_placed = true;
+    }
+
+    /**
+     * @brief moves objects by their velocity, an object reaching a border bounces on it.
+     * @param frame(in): next frame.
+     */
+    void moveObjects(const VideoFrame &frame)
+    {
+        for (auto &object : m_objects)
+        {
+            const auto &shape = m_config.m_shapes[object.m_shapeId];
+            bounce(object.m_x, object.m_velocityX, max(0.0, double(frame.m_width) - double(shape[0].size())));
+            bounce(object.m_y, object.m_velocityY, max(0.0, double(frame.m_height) - double(shape.size())));
+        }
+    }
+
+    /**
+     * @brief moves one coordinate in [0, range] reflecting it on bounds.
+     * @param position(in/out): coordinate.
+     * @param velocity(in/out): speed along coordinate, sign changes on reflection.
+     * @param range(in): max coordinate.
+     */
+    static void bounce(double &position, double &velocity, double range)
+    {
+        if (range <= 0)
+        {
+            position = 0;
+            return;
+        }
+        position += velocity;
+        while ((position < 0) || (position > range))
+        {
+            position = (position < 0) ? -position : 2 * range - position;
+            velocity = -velocity;
+        }
+    }
+
+    MotionSceneConfig m_config; /**< scene options. */
+    Xoshiro256StarStar m_randomGenerator; /**< generator of scene and pixels. */
+    vector<MovingObject> m_objects; /**< objects of scene. */
+    vector<uint8_t> m_background; /**< static background pixels (width * height), empty for a changing background. */
+    bool m_placed; /**< true once objects are placed (on first frame). */
+    uint64_t m_previousSequence; /**< sequence number of previous generated frame. */
+    vector<ObjectPlacement> m_previousPlacements; /**< objects of previous generated frame. */
+};
+
+/**
+ * @brief reader of a raw frames file (headerless frames of width * height Gray8 bytes, for instance
+ * recorded with ffmpeg -f rawvideo -pix_fmt gray) memory mapped once : frames are views of the mapping
+ * (no copy), so that recorded footage is replayed at disk (or page cache) speed. kernel is told
+ * mapping is read sequentially and next frames are requested ahead of use.
+ * mapping is private : pixels marking of a view writes a private copy of its pages, never the file,
+ * and a looping replay maps file again so that replayed frames are not marked.
+ */
+class MappedFileFrameGenerator: public FrameGenerator
+{
+public:
+    static constexpr size_t kDefaultReadaheadFrames = 8; /**< default frames requested ahead of use. */
+
+    /**
+     * @brief MappedFileFrameGenerator constructor, throws invalid_argument when file cannot be mapped
+     * or holds no frame (a last partial frame is ignored).
+     * @param path(in): path of raw frames file.
+     * @param width(in): width of frames.
+     * @param height(in): height of frames.
+     * @param loop(in): replays file from its first frame once last one is given, stops otherwise.
+     * @param readaheadFrames(in): frames requested ahead of use (0 for no request).
+     */
+    MappedFileFrameGenerator(const string &path, uint32_t width, uint32_t height, bool loop = false,
+                             size_t readaheadFrames = kDefaultReadaheadFrames) :
+            m_width(width), m_height(height), m_frameSize(size_t(width) * height), m_loop(loop),
+            m_readaheadFrames(readaheadFrames), m_path(path), m_fd(-1), m_frameCount(0), m_nextFrame(0), m_exhausted(false)
+    {
+        if (m_frameSize == 0)
+            throw invalid_argument("MappedFileFrameGenerator frames must not be empty");
+        m_fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (m_fd < 0)
+            throw invalid_argument("cannot open raw frames file " + path + " : " + strerror(errno));
+        struct stat status;
+        if (fstat(m_fd, &status) != 0)
+        {
+            const int error = errno;
+            close(m_fd);
+            throw invalid_argument("cannot stat raw frames file " + path + " : " + strerror(error));
+        }
+        const size_t fileSize = static_cast<size_t>(status.st_size);
+        m_frameCount = fileSize / m_frameSize;
+        try
+        {
+            if (m_frameCount == 0)
+                throw invalid_argument("raw frames file " + path + " holds no frame of " + to_string(width) + "x" + to_string(height));
+            mapFile();
+        } catch (...)
+        {
+            close(m_fd);
+            throw;
+        }
+        if (fileSize % m_frameSize)
+            MD_LOG(LogLevel::Info, "MappedFileFrameGenerator ignores last partial frame of " << path << "\n");
+    }
+    /**
+     * @brief MappedFileFrameGenerator destructor, mapping stays valid until last frame view is released.
+     */
+    ~MappedFileFrameGenerator()
+    {
+        close(m_fd);
+    }
+    MappedFileFrameGenerator(const MappedFileFrameGenerator &) = delete;
+    MappedFileFrameGenerator& operator=(const MappedFileFrameGenerator &) = delete;
+
+    /**
+     * @brief copies next frame in a frame of source pool (views are given by generateView).
+     * @param frame(in/out): Gray8 frame of file frames size.
+     */
+    void generate(VideoFrame &frame) override
+    {
+        size_t index = 0;
+        if (!advance(index))
+            return;
+        const uint8_t *pixels = m_mapping->m_address + index * m_frameSize;
+        for (size_t y = 0; y < m_height; y++)
+            memcpy(frame.row(y).data(), pixels + y * m_width, m_width);
+    }
+
+    shared_ptr<VideoFrame> generateView() override
+    {
+        size_t index = 0;
+        if (!advance(index))
+            return nullptr;
+        return make_shared<VideoFrame>(m_width, m_height, m_mapping->m_address + index * m_frameSize, m_width, m_mapping);
+    }
+
+    bool exhausted() const override
+    {
+        return m_exhausted;
+    }
+
+    /**
+     * @brief number of frames of file.
+     * @return size_t: frames count.
+     */
+    size_t frameCount() const
+    {
+        return m_frameCount;
+    }
+
+private:
+    /**
+     * @brief mapped frames, unmapped with last frame view.
+     */
+    struct Mapping
+    {
+        Mapping(uint8_t *address, size_t size) : m_address(address), m_size(size)
+        {
+        }
+        ~Mapping()
+        {
+            munmap(m_address, m_size);
+        }
+        uint8_t *m_address; /**< first byte of mapping. */
+        size_t m_size; /**< size of mapping in bytes. */
+    };
+
+    /**
+     * @brief index of next frame, requests next frames ahead every readahead frames.
+     * @param index(out): index of frame in file.
+     * @return bool: false once last frame was given (not looping).
+     */
+    bool advance(size_t &index)
+    {
+        if (m_nextFrame == m_frameCount)
+        {
+            if (!m_loop)
+            {
+                m_exhausted = true;
+                return false;
+            }
+            m_nextFrame = 0;
+            mapFile();
+        }
+        index = m_nextFrame++;
+        if (m_readaheadFrames && ((index % m_readaheadFrames) == 0))
+            adviseReadahead(index + m_readaheadFrames);
+        return true;
+    }
+
+    /**
+     * @brief maps frames of file (previous mapping is released with its last frame view).
+     */
+    void mapFile()
+    {
+        const size_t size = m_frameCount * m_frameSize;
+        void *address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, m_fd, 0);
+        if (address == MAP_FAILED)
+            throw invalid_argument("cannot map raw frames file " + m_path + " : " + strerror(errno));
+        m_mapping = make_shared<Mapping>(static_cast<uint8_t*>(address), size);
+        madvise(address, size, MADV_SEQUENTIAL);
+        adviseReadahead(0);
+    }
+
+    /**
+     * @brief asks kernel to read readahead frames from a frame (pages of mapping covering them).
+     * @param first(in): first frame index.
+     */
+    void adviseReadahead(size_t first)
+    {
+        if ((m_readaheadFrames == 0) || (first >= m_frameCount))
+            return;
+        static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        const size_t begin = (first * m_frameSize) / pageSize * pageSize;
+        const size_t end = min(first + m_readaheadFrames, m_frameCount) * m_frameSize;
+        madvise(m_mapping->m_address + begin, end - begin, MADV_WILLNEED);
+    }
+
+    uint32_t m_width; /**< width of frames. */
+    uint32_t m_height; /**< height of frames. */
+    size_t m_frameSize; /**< bytes of one frame in file. */
+    bool m_loop; /**< see constructor. */
+    size_t m_readaheadFrames; /**< see constructor. */
+    string m_path; /**< path of file. */
+    int m_fd; /**< descriptor of file. */
+    size_t m_frameCount; /**< see frameCount. */
+    size_t m_nextFrame; /**< index of next given frame. */
+    bool m_exhausted; /**< see exhausted. */
+    shared_ptr<Mapping> m_mapping; /**< mapped frames shared with views. */
+};
+
+/**
+ * @brief reader of raw frames (same layout as MappedFileFrameGenerator) streamed from a pipe or
+ * standard input, for instance output of a capture process. pixels are read through a large stdio
+ * buffer straight into rows of frames of source pool, generation stops at end of stream.
+ */
+class RawStreamFrameGenerator: public FrameGenerator
+{
+public:
+    static constexpr size_t kBufferSize = 1 << 20; /**< bytes of stream read buffer. */
+
+    /**
+     * @brief RawStreamFrameGenerator constructor, throws invalid_argument when stream cannot be opened.
+     * @param path(in): path of a pipe or file, - for standard input.
+     * @param width(in): width of frames.
+     * @param height(in): height of frames.
+     */
+    RawStreamFrameGenerator(const string &path, uint32_t width, uint32_t height) :
+            m_width(width), m_height(height), m_file(nullptr), m_buffer(kBufferSize), m_exhausted(false)
+    {
+        m_file = (path == "-") ? fdopen(dup(STDIN_FILENO), "rb") : fopen(path.c_str(), "rb");
+        if (m_file == nullptr)
+            throw invalid_argument("cannot open raw frames stream " + path + " : " + strerror(errno));
+        setvbuf(m_file, m_buffer.data(), _IOFBF, m_buffer.size());
+#if defined(POSIX_FADV_SEQUENTIAL)
+        // no effect on pipes
+        posix_fadvise(fileno(m_file), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    }
+    ~RawStreamFrameGenerator()
+    {
+        fclose(m_file);
+    }
+    RawStreamFrameGenerator(const RawStreamFrameGenerator &) = delete;
+    RawStreamFrameGenerator& operator=(const RawStreamFrameGenerator &) = delete;
+
+    void generate(VideoFrame &frame) override
+    {
+        for (size_t y = 0; (y < m_height) && !m_exhausted; y++)
+        {
+            const size_t count = fread(frame.row(y).data(), 1, m_width, m_file);
+            if (count == m_width)
+                continue;
+            m_exhausted = true;
+            if ((y > 0) || (count > 0))
+                MD_LOG(LogLevel::Info, "RawStreamFrameGenerator ignores last partial frame\n");
+        }
+    }
+
+    bool exhausted() const override
+    {
+        return m_exhausted;
+    }
+
+private:
+    uint32_t m_width; /**< width of frames. */
+    uint32_t m_height; /**< height of frames. */
+    FILE *m_file; /**< stream of frames. */
+    vector<char> m_buffer; /**< read buffer of stream. */
+    bool m_exhausted; /**< see exhausted. */
+};
+
+/**
+ * @brief video source element class to randomly generate frame video with a specified frame rate, width and height.
+ */
+class VideoSourceElement: public BaseElement
+{
+public:
+    /**
+     * @brief VideoSourceElement constructor.
+     * @param width(in): width of frames to randomly generate.
+     * @param height(in): height of frames to randomly generate.
+     * @param frameRate(in): frequency of frame generation expressed in number of frames per second),
+     * kUnthrottled to generate frames as fast as possible.
+     * @param framePoolCapacity(in): max number of released frames kept for reuse.
+     */
+    VideoSourceElement(uint32_t width, uint32_t height, double frameRate, size_t framePoolCapacity = kDefaultFramePoolCapacity) :
+            m_width(width), m_height(height), m_frameRate(frameRate), m_internalThread{}, m_runningState(false),
+            m_sequenceNumber(0), m_framePool(width, height, framePoolCapacity), m_executor(nullptr), m_tickScheduled(false),
+            m_nextDeadline{}, m_missedDeadlines(0), m_frameGenerator(make_unique<NoiseFrameGenerator>(random_device{}())),
+            m_pixelFormat(PixelFormat::Gray8)
+    {
+        if (!(frameRate >= 0))
+            throw invalid_argument("VideoSourceElement frame rate must be positive (0 for unthrottled)");
+    }
+    /**
+     * @brief VideoSourceElement Destructor.
+     */
+    ~VideoSourceElement()
+    {
+        stop();
+        if (m_internalThread.joinable())
+            m_internalThread.join();
+    }
+
+    /**
+     * @brief replaces pixels generator (by default independent noise frames with a random seed), for
+     * instance by a MovingObjectsFrameGenerator. to be called before start.
+     * @param frameGenerator(in): generator of frames.
+     */
+    void setFrameGenerator(unique_ptr<FrameGenerator> frameGenerator)
+    {
+        if (!frameGenerator)
+            throw invalid_argument("VideoSourceElement frame generator is null");
+        m_frameGenerator = move(frameGenerator);
+    }
+
+    /**
+     * @brief runs frames generation as delayed tasks of an executor instead of a dedicated thread.
+     * to be called before start.
+     * @param executor(in): executor outliving source, null for a dedicated thread.
+     */
+    void setExecutor(PipelineExecutor *executor)
+    {
+        m_executor = executor;
+    }
+
+    /**
+     * @brief selects pixels format of generated frames (Gray8 by default). frames of a generator
+     * writing only Gray8 pixels are generated in a Gray8 frame then converted. to be called before start.
+     * @param format(in): pixels format.
+     */
+    void setPixelFormat(PixelFormat format)
+    {
+        m_framePool = FramePool(m_width, m_height, m_framePool.capacity(), format, m_framePool.numaNode());
+        m_pixelFormat = format;
+    }
+
+    /**
+     * @brief pins dedicated thread of source to cores (ignored for a source run by an executor, see
+     * setExecutor). to be called before start.
+     * @param cpus(in): cores of thread, empty for no pinning.
+     */
+    void setAffinity(vector<unsigned> cpus)
+    {
+        m_cpus = move(cpus);
+    }
+
+    /**
+     * @brief allocates pixels of generated frames on a NUMA node, typically node of consuming thread.
+     * to be called before start.
+     * @param numaNode(in): NUMA node, -1 for node of allocating thread.
+     */
+    void setNumaNode(int numaNode)
+    {
+        m_framePool = FramePool(m_width, m_height, m_framePool.capacity(), m_pixelFormat, numaNode);
+    }
+
+    /**
+     * @brief starts thread (or executor tasks) to generate frames and then we will be blocked until join
+     * of thread (stop of it).
+     */
+    void start()
+    {
+        launch();
+        wait();
+    }
+
+    /**
+     * @brief starts thread (or executor tasks) to generate frames without waiting for them, so that
+     * one thread starts many sources (see wait). a stopped source can be launched again (a generation
+     * still stopping ends first), frames sequence numbers go on.
+     */
+    void launch()
+    {
+        unique_lock<mutex> lock(m_tickLock);
+        if (m_runningState)
+            return;
+        m_tickCv.wait(lock, [this] { return !m_tickScheduled; });
+        m_runningState = true;
+        m_tickScheduled = true;
+        m_nextDeadline = FrameClock::now();
+        if (m_executor)
+        {
+            m_executor->submit([this] { generateOnExecutor(); });
+            return;
+        }
+
+        // previous thread has ended (it cleared m_tickScheduled as last step)
+        if (m_internalThread.joinable())
+            m_internalThread.join();
+        m_internalThread = thread(&VideoSourceElement::RandomVideoFramesGenerator, this);
+        CpuAffinity::pin(m_internalThread.native_handle(), m_cpus);
+    }
+
+    /**
+     * @brief blocks until a launched source is stopped (or its frame generator is exhausted), from
+     * any number of threads. dedicated thread is joined by next launch or by destructor.
+     */
+    void wait()
+    {
+        unique_lock<mutex> lock(m_tickLock);
+        m_tickCv.wait(lock, [this] { return !m_tickScheduled; });
+    }
+
+    /**
+     * @brief stops generation of frames if started and waits for end of frame being pushed (frames
+     * waiting for next frame period are not generated), from any thread but one of the source.
+     */
+    void stop ()
+    {
+        requestStop();
+        wait();
+    }
+
+    /**
+     * @brief asks generation of frames to stop without waiting for it (see wait), for instance
+     * to stop many sources at once.
+     */
+    void requestStop()
+    {
+        {
+            lock_guard<mutex> lock(m_tickLock);
+            m_runningState = false;
+            // generation task waiting for its deadline is cancelled (its timer runs nothing)
+            if (m_pendingTick && !m_pendingTick->exchange(true))
+                m_tickScheduled = false;
+            m_pendingTick.reset();
+        }
+        // wakes dedicated thread sleeping until its next deadline
+        m_tickCv.notify_all();
+    }
+
+    /**
+     * @brief running state of source.
+     * @return bool: true from launch until stop is requested or generator is exhausted.
+     */
+    bool running() const
+    {
+        return m_runningState;
+    }
+
+    /**
+     * @brief first node in pipeline. Video source generates random frame and forward it for processing
+     * to next element.
+     * @param videoFrame(in): shared pointer of video frame.
+     * @return void.
+     */
+    void process(shared_ptr<VideoFrame> videoFrame) override
+    {
+        processAndPushDownstream(videoFrame);
+    }
+
+    /**
+     * @brief statistics of frame pool used to generate frames.
+     * @return FramePoolStats.
+     */
+    FramePoolStats framePoolStats() const
+    {
+        return m_framePool.stats();
+    }
+
+    /**
+     * @brief number of frame periods missed because generating and pushing a frame took longer than
+     * time left before its deadline (pipeline falls behind frame rate).
+     * @return uint64_t: missed deadlines count.
+     */
+    uint64_t missedDeadlines() const
+    {
+        return m_missedDeadlines.load(memory_order_relaxed);
+    }
+
+    static constexpr size_t kDefaultFramePoolCapacity = 4; /**< default free list size of frame pool. */
+    static constexpr double kUnthrottled = 0; /**< frame rate of a source generating frames as fast as possible. */
+private:
+    uint32_t m_width; /**< width of frame . */
+    uint32_t m_height;/**< height of frame . */
+    double m_frameRate; /**< frame rate : frequency of frame generation expressed in frame per second. */
+    thread m_internalThread;/**< thread used to generate random frames. */
+    atomic<bool> m_runningState;/**< boolean to keep status of thread running true : run false : down. */
+    uint64_t m_sequenceNumber;/**< sequence number of next generated frame. */
+    shared_ptr<VideoFrame> m_videoFrame;/**< shared pointer of video frame. */
+    FramePool m_framePool;/**< pool of recycled frames. */
+    PipelineExecutor *m_executor;/**< executor running generation tasks, null for a dedicated thread. */
+    mutex m_tickLock;/**< protects scheduled state of generation task (or dedicated thread) and its running state changes. */
+    condition_variable m_tickCv;/**< notified when generation task is not rescheduled anymore (or stop of dedicated thread is requested). */
+    bool m_tickScheduled;/**< true while a generation task is scheduled on executor (or dedicated thread generates frames). */
+    shared_ptr<atomic<bool>> m_pendingTick;/**< claim of generation task waiting for its deadline on executor timer. */
+    FrameClock::time_point m_nextDeadline;/**< deadline of next generated frame. */
+    atomic<uint64_t> m_missedDeadlines;/**< see missedDeadlines. */
+    unique_ptr<FrameGenerator> m_frameGenerator;/**< generator of pixels. */
+    PixelFormat m_pixelFormat;/**< pixels format of generated frames. */
+    unique_ptr<VideoFrame> m_bytesFrame;/**< Gray8 frame of a generator not writing pixels format, see generateConverted. */
+    vector<unsigned> m_cpus;/**< cores of dedicated thread, see setAffinity. */
+
+    friend class BenchmarkSuite; /**< benchmarks generate frames without source thread. */
+
+    /**
+     * @brief period between two generated frames (kept in steady clock resolution).
+     * @return FrameClock::duration: zero for unthrottled source.
+     */
+    FrameClock::duration framePeriod() const
+    {
+        return (m_frameRate == kUnthrottled) ? FrameClock::duration::zero() :
+               chrono::duration_cast<FrameClock::duration>(chrono::duration<double>(1.0 / m_frameRate));
+    }
+
+    /**
+     * @brief advances deadline of next frame by one frame period. when current time is already past
+     * it, whole missed periods are counted and skipped (no burst of late frames) keeping deadlines
+     * on frame rate grid.
+     * @param period(in): frame period.
+     */
+    void advanceDeadline(FrameClock::duration period)
+    {
+        m_nextDeadline += period;
+        const auto now = FrameClock::now();
+        if (now > m_nextDeadline)
+        {
+            const auto missed = (now - m_nextDeadline) / period + 1;
+            m_nextDeadline += missed * period;
+            m_missedDeadlines.fetch_add(static_cast<uint64_t>(missed), memory_order_relaxed);
+            MD_LOG(LogLevel::Debug, "VideoSourceElement missed " << missed << " frame deadlines\n");
+        }
+    }
+
+    /**
+     * @brief generation task executed on executor : generates and pushes one frame then
+     * schedules next generation at next deadline (immediately when unthrottled) while source is running.
+     */
+    void generateOnExecutor(void)
+    {
+        if (m_runningState)
+        {
+            auto videoFrame = GenerateVideoFrame();
+            if (videoFrame)
+                processAndPushDownstream(videoFrame);
+            else
+                endOfStream();
+        }
+
+        lock_guard<mutex> lock(m_tickLock);
+        m_pendingTick.reset();
+        if (m_runningState)
+        {
+            const auto period = framePeriod();
+            if (period == FrameClock::duration::zero())
+            {
+                m_executor->yield([this] { generateOnExecutor(); });
+                return;
+            }
+            advanceDeadline(period);
+            // claimed by timer or by requestStop, whichever comes first
+            auto tick = make_shared<atomic<bool>>(false);
+            m_pendingTick = tick;
+            m_executor->submitAt(m_nextDeadline, [this, tick]
+            {
+                if (!tick->exchange(true))
+                    generateOnExecutor();
+            });
+            return;
+        }
+        m_tickScheduled = false;
+        m_tickCv.notify_all();
+    }
+
+    /**
+     * @brief method executes inside thread to generate random frames.
+     * it generates frame push frame to next element and sleeps until deadline of next frame
+     * according to frame rate specified by user for example for framerate =10 frame per seconds
+     * frames are generated every 100 ms on steady clock whatever time spent by pipeline to process
+     * them (period is kept in steady clock resolution, fractional frame rates are supported).
+     * unthrottled source does not sleep.
+     * it can be interrupted by setting m_runningState to false
+     * @param void.
+     * @return void.
+     */
+    void RandomVideoFramesGenerator(void)
+    {
+        const auto period = framePeriod();
+        while (m_runningState)
+        {
+            auto videoFrame = GenerateVideoFrame();
+            if (!videoFrame)
+            {
+                endOfStream();
+                break;
+            }
+            processAndPushDownstream(videoFrame);
+            if (period == FrameClock::duration::zero())
+                continue;
+            advanceDeadline(period);
+            // sleeps until deadline unless stop is requested
+            unique_lock<mutex> lock(m_tickLock);
+            m_tickCv.wait_until(lock, m_nextDeadline, [this] { return !m_runningState; });
+        }
+
+        lock_guard<mutex> lock(m_tickLock);
+        m_tickScheduled = false;
+        m_tickCv.notify_all();
+    }
+
+    /**
+     * @brief stops generation once frame generator is exhausted (end of a recorded stream).
+     */
+    void endOfStream()
+    {
+        m_runningState = false;
+        MD_LOG(LogLevel::Info, "VideoSourceElement end of stream after " << m_sequenceNumber << " frames\n");
+    }
+
+    /**
+     * @brief method to generate randomly Video Frame.
+     * frame generator of source is used in order to generate pixels values
+     * in set {0, 1} (see NoiseFrameGenerator, MovingObjectsFrameGenerator). pixels are two colors encoded.
+     * frame is acquired from frame pool, filled with generated pixels and returned as shared pointer.
+     * a generator giving views of its memory (see FrameGenerator::generateView) gives frame itself,
+     * it is copied in a pool frame only when pixels format differs.
+     * @param void.
+     * @return VideoFrame : shared pointer with generated video frame, null once generator is exhausted.
+     */
+    shared_ptr<VideoFrame> GenerateVideoFrame(void)
+    {
+        MD_LOG(LogLevel::Debug, "\n New Frame Generated Width : " << unsigned(m_width) << " Height : " << unsigned(m_height) << "\n");
+
+        MD_LOG(LogLevel::Debug, "GenerateVideoFrame before acquire counter : " << m_videoFrame.use_count() << " pointer " << m_videoFrame.get() << "\n");
+        const auto captureTimestamp = FrameClock::now();
+        const bool instrumented = ElementCounters::isEnabled();
+        const auto start = instrumented ? FrameClock::now() : FrameClock::time_point{};
+        m_videoFrame = m_frameGenerator->generateView();
+        if (m_videoFrame && (m_videoFrame->format() != m_pixelFormat))
+        {
+            auto converted = m_framePool.acquire();
+            converted->convertPixels(*m_videoFrame);
+            m_videoFrame = move(converted);
+        }
+        if (m_videoFrame)
+        {
+            m_videoFrame->m_sequenceNumber = m_sequenceNumber;
+            m_videoFrame->m_captureTimestamp = captureTimestamp;
+        }
+        else
+        {
+            m_videoFrame = m_framePool.acquire();
+            m_videoFrame->m_sequenceNumber = m_sequenceNumber;
+            m_videoFrame->m_captureTimestamp = captureTimestamp;
+            if (m_frameGenerator->generates(m_pixelFormat))
+                m_frameGenerator->generate(*m_videoFrame);
+            else
+                generateConverted(*m_videoFrame);
+        }
+        if (m_frameGenerator->exhausted())
+        {
+            m_videoFrame.reset();
+            return nullptr;
+        }
+        m_sequenceNumber++;
+        // generated frames are frames in of source, generation is its process time
+        if (instrumented)
+        {
+            const auto end = FrameClock::now();
+            counters().recordProcess(1, end - start);
+            counters().recordLatency(*m_videoFrame, end);
+        }
+
+        // per pixel dump is built only when trace level is enabled
+        MD_LOG(LogLevel::Trace, pixelsDump(*m_videoFrame));
+
+        return m_videoFrame;
+    }
+
+    /**
+     * @brief generates pixels and metadata of frame in a Gray8 frame then converts pixels to format
+     * of frame (generator not writing format of frame).
+     * @param frame(in/out): frame to fill.
+     */
+    void generateConverted(VideoFrame &frame)
+    {
+        if (!m_bytesFrame)
+            m_bytesFrame = make_unique<VideoFrame>(m_width, m_height);
+        m_bytesFrame->m_sequenceNumber = frame.m_sequenceNumber;
+        m_bytesFrame->m_captureTimestamp = frame.m_captureTimestamp;
+        m_frameGenerator->generate(*m_bytesFrame);
+        frame.convertPixels(*m_bytesFrame);
+        swap(frame.m_groundTruth, m_bytesFrame->m_groundTruth);
+        swap(frame.m_changes, m_bytesFrame->m_changes);
+    }
+
+    /**
+     * @brief formats frame pixels values (one line per row) for trace log.
+     * @param videoFrame(in): video frame to dump.
+     * @return string: formatted pixels.
+     */
+    static string pixelsDump(const VideoFrame &videoFrame)
+    {
+        string dump;
+        dump.reserve((videoFrame.m_width * 2 + 1) * videoFrame.m_height + 1);
+        vector<uint8_t> pixels(videoFrame.m_width);
+        for (size_t i = 0; i < videoFrame.m_height; i++)
+        {
+            videoFrame.unpackRow(i, pixels.data());
+            for (const auto pixel : pixels)
+            {
+                dump += static_cast<char>('0' + pixel);
+                dump += ' ';
+            }
+            dump += '\n';
+        }
+        dump += '\n';
+        return dump;
+    }
+};
+
+/**
+ * @brief display element to process frame rate and display it in stdout.
+ */
+class DisplayElement: public BaseElement
+{
+public:
+    /**
+     * @brief how frames are printed.
+     */
+    enum class Mode : int
+    {
+        Scroll = 0, /**< each frame is printed after previous one. */
+        InPlace = 1 /**< frames of same size are printed over previous one (ANSI terminal), only dirty rows are redrawn. */
+    };
+
+    /**
+     * @brief DisplayElement Constructor.
+     * @param mode(in): how frames are printed.
+     */
+    DisplayElement(Mode mode = Mode::Scroll) :
+            m_mode(mode), m_displayedState(false), m_displayedSequence(0), m_displayedWidth(0), m_displayedHeight(0)
+    {
+    }
+    /**
+     * @brief DisplayElement Destructor.
+     */
+    ~DisplayElement()
+    {
+    }
+
+    /**
+     * @brief process frame to print it in stdout (pixel 1 -> '+' 0 -> '.').
+     * @param videoFrame(in): shared pointer of video frame.
+     * @return void.
+     */
+    void process(shared_ptr<VideoFrame> videoFrame) override
+    {
+        printVideoFrame(videoFrame);
+    }
+
+    /**
+     * @brief process frame to print it in stdout (pixel 2 -> '$' 1 -> '+' 0 -> '.').
+     * whole frame is rendered in an internal buffer (capacity reused between frames)
+     * and written to stdout with one write.
+     * in InPlace mode a frame of same size than previous one is printed over it : when frame changes
+     * are relative to previous printed frame, only rows of dirty blocks and rows of current or previous
+     * detections are rendered, otherwise all rows.
+     * @param videoFrame(in): shared pointer of video frame.
+     * @return void.
+     */
+    void printVideoFrame(shared_ptr<VideoFrame> videoFrame)
+    {
+        const VideoFrame &frame = *videoFrame;
+        m_previousBoxes.swap(m_boxes);
+        frame.m_overlay.snapshot(m_boxes);
+        m_renderBuffer.clear();
+
+        if ((m_mode == Mode::InPlace) && m_displayedState && (frame.m_width == m_displayedWidth) && (frame.m_height == m_displayedHeight))
+        {
+            selectRedrawnRows(frame);
+            for (size_t y = 0; y < frame.m_height; y++)
+            {
+                if (!m_redrawnRows[y])
+                    continue;
+                // cursor is on line after blank line following last row
+                const size_t linesUp = frame.m_height - y + 1;
+                m_renderBuffer += "\x1b[" + to_string(linesUp) + "F";
+                renderRow(frame, y);
+                if (linesUp > 1)
+                    m_renderBuffer += "\x1b[" + to_string(linesUp - 1) + "E";
+            }
+        }
+        else
+        {
+            const string header = "\n New Frame Width : " + to_string(frame.m_width) +
+                                  " Height : " + to_string(frame.m_height) + "\n";
+            m_renderBuffer.reserve(header.size() + (frame.m_width * 2 + 1) * frame.m_height + 1);
+            m_renderBuffer += header;
+            for (size_t y = 0; y < frame.m_height; y++)
+            {
+                renderRow(frame, y);
+            }
+            m_renderBuffer += '\n';
+        }
+
+        m_displayedState = true;
+        m_displayedSequence = frame.m_sequenceNumber;
+        m_displayedWidth = frame.m_width;
+        m_displayedHeight = frame.m_height;
+        cout.write(m_renderBuffer.data(), m_renderBuffer.size());
+        cout.flush();
+    }
+
+private:
+    /**
+     * @brief renders one row of frame at end of render buffer.
+     * @param frame(in): video frame.
+     * @param y(in): row index.
+     */
+    void renderRow(const VideoFrame &frame, size_t y)
+    {
+        // pixels covered by a detection of overlay are printed as marked pixels (value 2)
+        m_boxMask.assign(frame.m_width, 0);
+        for (const auto &box : m_boxes)
+        {
+            if ((y >= box.m_y) && (y < box.m_y + box.m_height))
+                fill_n(m_boxMask.begin() + box.m_x, box.m_width, 1);
+        }
+
+        // Mono1 rows are converted to bytes (match mask flags are marked pixels)
+        const uint8_t *raw = frame.row(y).data();
+        if (frame.format() != PixelFormat::Gray8)
+        {
+            m_rowPixels.resize(frame.m_width);
+            frame.unpackRow(y, m_rowPixels.data());
+            raw = m_rowPixels.data();
+        }
+        for (size_t x = 0; x < frame.m_width; x++)
+        {
+            const auto pixel = (raw[x] && m_boxMask[x]) ? 2 : raw[x];
+            m_renderBuffer.append((pixel == 2) ? "$ " : ((pixel == 1) ? "+ " :". "), 2);
+        }
+        m_renderBuffer += '\n';
+    }
+
+    /**
+     * @brief selects rows to redraw over previous printed frame.
+     * @param frame(in): video frame.
+     */
+    void selectRedrawnRows(const VideoFrame &frame)
+    {
+        const FrameChanges &changes = frame.m_changes;
+        const bool incremental = changes.m_valid && (changes.m_referenceSequence == m_displayedSequence);
+        m_redrawnRows.assign(frame.m_height, !incremental);
+        if (!incremental)
+            return;
+
+        for (size_t y = 0; y < frame.m_height; y++)
+            m_redrawnRows[y] = changes.isRowDirty(y / changes.m_blockHeight);
+        for (const auto *boxes : {&m_boxes, &m_previousBoxes})
+            for (const auto &box : *boxes)
+                fill_n(m_redrawnRows.begin() + box.m_y, min<size_t>(box.m_height, frame.m_height - box.m_y), 1);
+    }
+
+    Mode m_mode;/**< how frames are printed. */
+    bool m_displayedState;/**< true once a frame is printed. */
+    uint64_t m_displayedSequence;/**< sequence number of last printed frame. */
+    uint32_t m_displayedWidth;/**< width of last printed frame. */
+    uint32_t m_displayedHeight;/**< height of last printed frame. */
+    string m_renderBuffer;/**< rendered frame text. */
+    vector<DetectionBox> m_boxes;/**< detections of rendered frame. */
+    vector<DetectionBox> m_previousBoxes;/**< detections of previous rendered frame. */
+    vector<uint8_t> m_boxMask;/**< pixels of current row covered by a detection. */
+    vector<uint8_t> m_rowPixels;/**< bytes of current row of a Mono1 frame. */
+    vector<uint8_t> m_redrawnRows;/**< rows of frame to redraw in InPlace mode. */
+};
+
+/**
+ * @brief position (top left corner) of a pattern found in a video frame.
+ */
+struct PatternPosition
+{
+    size_t m_x; /**< column of pattern first pixel. */
+    size_t m_y; /**< row of pattern first pixel. */
+};
+
+/**
+ * @brief instruction sets of pattern search kernels. availability depends on build options
+ * (MOTIONDETECTOR_DISABLE_SSE2, MOTIONDETECTOR_DISABLE_AVX2, MOTIONDETECTOR_DISABLE_NEON) and
+ * on cpu at runtime, scalar kernels are always available.
+ */
+enum class SimdLevel : int
+{
+    Scalar = 0, /**< portable C++ kernels. */
+    Sse2 = 1,   /**< x86 128 bits kernels. */
+    Avx2 = 2,   /**< x86 256 bits kernels. */
+    Neon = 3    /**< arm 128 bits kernels. */
+};
+
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(MOTIONDETECTOR_DISABLE_SSE2)
+#define MOTIONDETECTOR_WITH_SSE2
+#endif
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(MOTIONDETECTOR_DISABLE_AVX2)
+#define MOTIONDETECTOR_WITH_AVX2
+#endif
+#if defined(__aarch64__) && defined(__ARM_NEON) && !defined(MOTIONDETECTOR_DISABLE_NEON)
+#define MOTIONDETECTOR_WITH_NEON
+#endif
+
+/**
+ * @brief frame rows packed as bit planes handed to row matches kernels, see PackedFrameRows.
+ */
+struct RowMatchArgs
+{
+    const uint64_t *m_ones; /**< ones plane of frame row 0. */
+    const uint64_t *m_zeros; /**< zeros plane of frame row 0. */
+    size_t m_rowWords; /**< distance in words between two plane rows (words per row + padding word). */
+    size_t m_wordsPerRow; /**< number of words covering frame width. */
+    const uint64_t *m_patternRows; /**< bit c of word k set when pattern pixel (c, k) is 1. */
+    size_t m_patternWidth; /**< pattern width (<= 64). */
+    size_t m_patternHeight; /**< pattern height. */
+};
+
+using PackRowKernel = void (*)(const uint8_t *pixels, size_t width, uint64_t *ones, uint64_t *zeros);
+using MarkRowKernel = void (*)(uint8_t *pixels, size_t count);
+using FindRowMatchesKernel = void (*)(const RowMatchArgs &args, size_t y, vector<PatternPosition> &positions);
+
+/**
+ * @brief scalar kernels, also used for tails of vector kernels.
+ */
+namespace ScalarKernels
+{
+    /**
+     * @brief packs pixels [first, width) of a row (first multiple of 64) in ones/zeros planes words.
+     */
+    inline void packRowTail(const uint8_t *pixels, size_t first, size_t width, uint64_t *ones, uint64_t *zeros)
+    {
+        for (size_t word = first / 64; word * 64 < width; word++)
+        {
+            const size_t count = min<size_t>(64, width - word * 64);
+            uint64_t onesWord = 0;
+            uint64_t zerosWord = 0;
+            for (size_t bit = 0; bit < count; bit++)
+            {
+                const uint8_t pixel = pixels[word * 64 + bit];
+                onesWord |= uint64_t(pixel == 1) << bit;
+                zerosWord |= uint64_t(pixel == 0) << bit;
+            }
+            ones[word] = onesWord;
+            zeros[word] = zerosWord;
+        }
+    }
+
+    inline void packRow(const uint8_t *pixels, size_t width, uint64_t *ones, uint64_t *zeros)
+    {
+        packRowTail(pixels, 0, width, ones, zeros);
+    }
+
+    /**
+     * @brief marks count pixels : any non zero pixel becomes 2.
+     */
+    inline void markRow(uint8_t *pixels, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+            pixels[i] = (pixels[i] > 0 ? 2 : pixels[i]);
+    }
+
+    /**
+     * @brief reads 64 consecutive bits of a plane row starting at bit (word * 64 + shift), shift < 64.
+     */
+    inline uint64_t shiftedWord(const uint64_t *plane, size_t word, unsigned shift)
+    {
+        return shift ? ((plane[word] >> shift) | (plane[word + 1] << (64 - shift))) : plane[word];
+    }
+
+    /**
+     * @brief appends positions of set bits of candidates word.
+     */
+    inline void appendCandidates(uint64_t candidates, size_t word, size_t y, vector<PatternPosition> &positions)
+    {
+        while (candidates)
+        {
+            positions.push_back(PatternPosition{word * 64 + __builtin_ctzll(candidates), y});
+            candidates &= candidates - 1;
+        }
+    }
+
+    /**
+     * @brief finds pattern positions with first row y and x in words [firstWord, wordsPerRow).
+     * bits beyond width - pattern width are cleared by zero padding of planes.
+     */
+    inline void findRowMatchesFrom(const RowMatchArgs &args, size_t y, size_t firstWord, vector<PatternPosition> &positions)
+    {
+        for (size_t word = firstWord; word < args.m_wordsPerRow; word++)
+        {
+            uint64_t candidates = ~uint64_t(0);
+            for (size_t k = 0; (k < args.m_patternHeight) && candidates; k++)
+            {
+                const uint64_t *ones = args.m_ones + (y + k) * args.m_rowWords;
+                const uint64_t *zeros = args.m_zeros + (y + k) * args.m_rowWords;
+                const uint64_t bits = args.m_patternRows[k];
+                for (unsigned c = 0; (c < args.m_patternWidth) && candidates; c++)
+                    candidates &= shiftedWord(((bits >> c) & 1) ? ones : zeros, word, c);
+            }
+            appendCandidates(candidates, word, y, positions);
+        }
+    }
+
+    inline void findRowMatches(const RowMatchArgs &args, size_t y, vector<PatternPosition> &positions)
+    {
+        findRowMatchesFrom(args, y, 0, positions);
+    }
+}
+
+#if defined(MOTIONDETECTOR_WITH_SSE2) || defined(MOTIONDETECTOR_WITH_AVX2)
+#include <immintrin.h>
+#endif
+
+#if defined(MOTIONDETECTOR_WITH_SSE2)
+/**
+ * @brief SSE2 kernels : 16 pixels per compare, 2 words of candidates per operation.
+ */
+namespace Sse2Kernels
+{
+    __attribute__((target("sse2"))) inline void packRow(const uint8_t *pixels, size_t width, uint64_t *ones, uint64_t *zeros)
+    {
+        const __m128i one = _mm_set1_epi8(1);
+        const __m128i zero = _mm_setzero_si128();
+        size_t word = 0;
+        for (; (word + 1) * 64 <= width; word++)
+        {
+            uint64_t onesWord = 0;
+            uint64_t zerosWord = 0;
+            for (unsigned chunk = 0; chunk < 4; chunk++)
+            {
+                const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + word * 64 + chunk * 16));
+                onesWord |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(values, one)))) << (chunk * 16);
+                zerosWord |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(values, zero)))) << (chunk * 16);
+            }
+            ones[word] = onesWord;
+            zeros[word] = zerosWord;
+        }
+        ScalarKernels::packRowTail(pixels, word * 64, width, ones, zeros);
+    }
+
+    __attribute__((target("sse2"))) inline void markRow(uint8_t *pixels, size_t count)
+    {
+        const __m128i two = _mm_set1_epi8(2);
+        const __m128i zero = _mm_setzero_si128();
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i *chunk = reinterpret_cast<__m128i*>(pixels + i);
+            const __m128i values = _mm_loadu_si128(chunk);
+            _mm_storeu_si128(chunk, _mm_andnot_si128(_mm_cmpeq_epi8(values, zero), two));
+        }
+        ScalarKernels::markRow(pixels + i, count - i);
+    }
+
+    __attribute__((target("sse2"))) inline void findRowMatches(const RowMatchArgs &args, size_t y, vector<PatternPosition> &positions)
+    {
+        size_t word = 0;
+        for (; word + 2 <= args.m_wordsPerRow; word += 2)
+        {
+            __m128i candidates = _mm_set1_epi32(-1);
+            for (size_t k = 0; k < args.m_patternHeight; k++)
+            {
+                const uint64_t *ones = args.m_ones + (y + k) * args.m_rowWords + word;
+                const uint64_t *zeros = args.m_zeros + (y + k) * args.m_rowWords + word;
+                const uint64_t bits = args.m_patternRows[k];
+                for (unsigned c = 0; c < args.m_patternWidth; c++)
+                {
+                    const uint64_t *plane = ((bits >> c) & 1) ? ones : zeros;
+                    const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(plane));
+                    const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(plane + 1));
+                    const __m128i shifted = c ? _mm_or_si128(_mm_srl_epi64(low, _mm_cvtsi32_si128(c)),
+                                                             _mm_sll_epi64(high, _mm_cvtsi32_si128(64 - c))) : low;
+                    candidates = _mm_and_si128(candidates, shifted);
+                }
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(candidates, _mm_setzero_si128())) == 0xFFFF)
+                    break;
+            }
+            alignas(16) uint64_t words[2];
+            _mm_store_si128(reinterpret_cast<__m128i*>(words), candidates);
+            ScalarKernels::appendCandidates(words[0], word, y, positions);
+            ScalarKernels::appendCandidates(words[1], word + 1, y, positions);
+        }
+        ScalarKernels::findRowMatchesFrom(args, y, word, positions);
+    }
+}
+#endif
+
+#if defined(MOTIONDETECTOR_WITH_AVX2)
+/**
+ * @brief AVX2 kernels : 32 pixels per compare, 4 words of candidates per operation.
+ */
+namespace Avx2Kernels
+{
+    __attribute__((target("avx2"))) inline void packRow(const uint8_t *pixels, size_t width, uint64_t *ones, uint64_t *zeros)
+    {
+        const __m256i one = _mm256_set1_epi8(1);
+        const __m256i zero = _mm256_setzero_si256();
+        size_t word = 0;
+        for (; (word + 1) * 64 <= width; word++)
+        {
+            const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels + word * 64));
+            const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels + word * 64 + 32));
+            ones[word] = uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, one)))) |
+                         (uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, one)))) << 32);
+            zeros[word] = uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, zero)))) |
+                          (uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, zero)))) << 32);
+        }
+        ScalarKernels::packRowTail(pixels, word * 64, width, ones, zeros);
+    }
+
+    __attribute__((target("avx2"))) inline void markRow(uint8_t *pixels, size_t count)
+    {
+        const __m256i two = _mm256_set1_epi8(2);
+        const __m256i zero = _mm256_setzero_si256();
+        size_t i = 0;
+        for (; i + 32 <= count; i += 32)
+        {
+            __m256i *chunk = reinterpret_cast<__m256i*>(pixels + i);
+            const __m256i values = _mm256_loadu_si256(chunk);
+            _mm256_storeu_si256(chunk, _mm256_andnot_si256(_mm256_cmpeq_epi8(values, zero), two));
+        }
+        ScalarKernels::markRow(pixels + i, count - i);
+    }
+
+    __attribute__((target("avx2"))) inline void findRowMatches(const RowMatchArgs &args, size_t y, vector<PatternPosition> &positions)
+    {
+        size_t word = 0;
+        for (; word + 4 <= args.m_wordsPerRow; word += 4)
+        {
+            __m256i candidates = _mm256_set1_epi64x(-1);
+            for (size_t k = 0; k < args.m_patternHeight; k++)
+            {
+                const uint64_t *ones = args.m_ones + (y + k) * args.m_rowWords + word;
+                const uint64_t *zeros = args.m_zeros + (y + k) * args.m_rowWords + word;
+                const uint64_t bits = args.m_patternRows[k];
+                for (unsigned c = 0; c < args.m_patternWidth; c++)
+                {
+                    const uint64_t *plane = ((bits >> c) & 1) ? ones : zeros;
+                    const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(plane));
+                    const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(plane + 1));
+                    const __m256i shifted = c ? _mm256_or_si256(_mm256_srl_epi64(low, _mm_cvtsi32_si128(c)),
+                                                                _mm256_sll_epi64(high, _mm_cvtsi32_si128(64 - c))) : low;
+                    candidates = _mm256_and_si256(candidates, shifted);
+                }
+                if (_mm256_testz_si256(candidates, candidates))
+                    break;
+            }
+            if (!_mm256_testz_si256(candidates, candidates))
+            {
+                alignas(32) uint64_t words[4];
+                _mm256_store_si256(reinterpret_cast<__m256i*>(words), candidates);
+                for (unsigned i = 0; i < 4; i++)
+                    ScalarKernels::appendCandidates(words[i], word + i, y, positions);
+            }
+        }
+        ScalarKernels::findRowMatchesFrom(args, y, word, positions);
+    }
+}
+#endif
+
+#if defined(MOTIONDETECTOR_WITH_NEON)
+#include <arm_neon.h>
+/**
+ * @brief NEON kernels : 16 pixels per compare, 2 words of candidates per operation.
+ */
+namespace NeonKernels
+{
+    /**
+     * @brief converts 16 compare lanes (0xFF/0x00) to 16 bits mask.
+     */
+    inline uint16_t movemask(uint8x16_t lanes)
+    {
+        static const uint8_t weights[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+        const uint8x16_t bits = vandq_u8(lanes, vld1q_u8(weights));
+        return uint16_t(vaddv_u8(vget_low_u8(bits))) | (uint16_t(vaddv_u8(vget_high_u8(bits))) << 8);
+    }
+
+    inline void packRow(const uint8_t *pixels, size_t width, uint64_t *ones, uint64_t *zeros)
+    {
+        const uint8x16_t one = vdupq_n_u8(1);
+        const uint8x16_t zero = vdupq_n_u8(0);
+        size_t word = 0;
+        for (; (word + 1) * 64 <= width; word++)
+        {
+            uint64_t onesWord = 0;
+            uint64_t zerosWord = 0;
+            for (unsigned chunk = 0; chunk < 4; chunk++)
+            {
+                const uint8x16_t values = vld1q_u8(pixels + word * 64 + chunk * 16);
+                onesWord |= uint64_t(movemask(vceqq_u8(values, one))) << (chunk * 16);
+                zerosWord |= uint64_t(movemask(vceqq_u8(values, zero))) << (chunk * 16);
+            }
+            ones[word] = onesWord;
+            zeros[word] = zerosWord;
+        }
+        ScalarKernels::packRowTail(pixels, word * 64, width, ones, zeros);
+    }
+
+    inline void markRow(uint8_t *pixels, size_t count)
+    {
+        const uint8x16_t two = vdupq_n_u8(2);
+        const uint8x16_t zero = vdupq_n_u8(0);
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            const uint8x16_t values = vld1q_u8(pixels + i);
+            vst1q_u8(pixels + i, vbicq_u8(two, vceqq_u8(values, zero)));
+        }
+        ScalarKernels::markRow(pixels + i, count - i);
+    }
+
+    inline void findRowMatches(const RowMatchArgs &args, size_t y, vector<PatternPosition> &positions)
+    {
+        size_t word = 0;
+        for (; word + 2 <= args.m_wordsPerRow; word += 2)
+        {
+            uint64x2_t candidates = vdupq_n_u64(~uint64_t(0));
+            for (size_t k = 0; k < args.m_patternHeight; k++)
+            {
+                const uint64_t *ones = args.m_ones + (y + k) * args.m_rowWords + word;
+                const uint64_t *zeros = args.m_zeros + (y + k) * args.m_rowWords + word;
+                const uint64_t bits = args.m_patternRows[k];
+                for (unsigned c = 0; c < args.m_patternWidth; c++)
+                {
+                    const uint64_t *plane = ((bits >> c) & 1) ? ones : zeros;
+                    const uint64x2_t low = vld1q_u64(plane);
+                    const uint64x2_t high = vld1q_u64(plane + 1);
+                    const uint64x2_t shifted = c ? vorrq_u64(vshlq_u64(low, vdupq_n_s64(-int64_t(c))),
+                                                             vshlq_u64(high, vdupq_n_s64(64 - int64_t(c)))) : low;
+                    candidates = vandq_u64(candidates, shifted);
+                }
+                if ((vgetq_lane_u64(candidates, 0) | vgetq_lane_u64(candidates, 1)) == 0)
+                    break;
+            }
+            ScalarKernels::appendCandidates(vgetq_lane_u64(candidates, 0), word, y, positions);
+            ScalarKernels::appendCandidates(vgetq_lane_u64(candidates, 1), word + 1, y, positions);
+        }
+        ScalarKernels::findRowMatchesFrom(args, y, word, positions);
+    }
+}
+#endif
+
+/**
+ * @brief table of pattern search kernels of one instruction set, with runtime dispatch :
+ * active() returns best kernels supported by cpu unless another level was selected.
+ */
+struct SimdKernels
+{
+    SimdLevel m_level; /**< instruction set of kernels. */
+    PackRowKernel m_packRow; /**< packs a pixels row in ones/zeros bit planes. */
+    MarkRowKernel m_markRow; /**< marks pixels of found pattern (non zero -> 2). */
+    FindRowMatchesKernel m_findRowMatches; /**< finds pattern positions starting at a frame row. */
+
+    /**
+     * @brief kernels currently used by detectors.
+     * @return SimdKernels: active kernels table.
+     */
+    static const SimdKernels& active()
+    {
+        return *activeKernels().load(memory_order_acquire);
+    }
+
+    /**
+     * @brief selects kernels of a given instruction set.
+     * @param level(in): requested instruction set.
+     * @return bool: false (and active kernels unchanged) when level is not supported by build or cpu.
+     */
+    static bool select(SimdLevel level)
+    {
+        const SimdKernels *kernels = find(level);
+        if ((kernels == nullptr) || !isSupportedByCpu(level))
+            return false;
+        activeKernels().store(kernels, memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief best instruction set supported by build and cpu.
+     * @return SimdLevel.
+     */
+    static SimdLevel bestLevel()
+    {
+        for (auto level : {SimdLevel::Avx2, SimdLevel::Neon, SimdLevel::Sse2})
+        {
+            if (find(level) && isSupportedByCpu(level))
+                return level;
+        }
+        return SimdLevel::Scalar;
+    }
+
+    /**
+     * @brief instruction set name (scalar, sse2, avx2, neon).
+     * @param level(in): instruction set.
+     * @return const char*: name.
+     */
+    static const char* levelName(SimdLevel level)
+    {
+        static const char *names[] = {"scalar", "sse2", "avx2", "neon"};
+        return names[static_cast<int>(level)];
+    }
+
+private:
+    static const SimdKernels* find(SimdLevel level)
+    {
+        static const SimdKernels tables[] = {
+            {SimdLevel::Scalar, ScalarKernels::packRow, ScalarKernels::markRow, ScalarKernels::findRowMatches},
+#if defined(MOTIONDETECTOR_WITH_SSE2)
+            {SimdLevel::Sse2, Sse2Kernels::packRow, Sse2Kernels::markRow, Sse2Kernels::findRowMatches},
+#endif
+#if defined(MOTIONDETECTOR_WITH_AVX2)
+            {SimdLevel::Avx2, Avx2Kernels::packRow, Avx2Kernels::markRow, Avx2Kernels::findRowMatches},
+#endif
+#if defined(MOTIONDETECTOR_WITH_NEON)
+            {SimdLevel::Neon, NeonKernels::packRow, NeonKernels::markRow, NeonKernels::findRowMatches},
+#endif
+        };
+        for (const auto &table : tables)
+        {
+            if (table.m_level == level)
+                return &table;
+        }
+        return nullptr;
+    }
+
+    static bool isSupportedByCpu(SimdLevel level)
+    {
+        switch (level)
+        {
+#if defined(__x86_64__) || defined(__i386__)
+        case SimdLevel::Sse2:
+            return __builtin_cpu_supports("sse2");
+        case SimdLevel::Avx2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        case SimdLevel::Neon:
+            // NEON is part of aarch64 base instruction set
+            return find(SimdLevel::Neon) != nullptr;
+        default:
+            return level == SimdLevel::Scalar;
+        }
+    }
+
+    static atomic<const SimdKernels*>& activeKernels()
+    {
+        static atomic<const SimdKernels*> kernels{find(bestLevel())};
+        return kernels;
+    }
+};
+
+/**
+ * @brief video frame rows packed as bit planes : for each row, bit x of ones plane is set
+ * when pixel x equals 1 and bit x of zeros plane is set when pixel x equals 0 (any other
+ * value, for example 2 used to mark found patterns, sets no bit). each row is stored in
+ * wordsPerRow() 64 bits words followed by one zero padding word so that reading bits
+ * x .. x + 63 never needs a bound check. bits beyond frame width are zero in both planes.
+ */
+class PackedFrameRows
+{
+public:
+    /**
+     * @brief PackedFrameRows constructor (empty planes).
+     */
+    PackedFrameRows() : m_width(0), m_height(0), m_wordsPerRow(0)
+    {
+    }
+
+    /**
+     * @brief packs all rows of video frame, planes capacity is reused between frames.
+     * @param videoFrame(in): video frame to pack.
+     */
+    void pack(const VideoFrame &videoFrame)
+    {
+        resize(videoFrame);
+        packRows(videoFrame, 0, m_height);
+    }
+
+    /**
+     * @brief sizes planes for video frame without packing any row.
+     * @param videoFrame(in): video frame to pack.
+     */
+    void resize(const VideoFrame &videoFrame)
+    {
+        m_width = videoFrame.m_width;
+        m_height = videoFrame.m_height;
+        m_wordsPerRow = (m_width + 63) / 64;
+        m_onesPlane.resize(m_height * (m_wordsPerRow + 1));
+        m_zerosPlane.resize(m_height * (m_wordsPerRow + 1));
+    }
+
+    /**
+     * @brief packs rows [firstRow, lastRow) of video frame in planes sized by resize. disjoint
+     * row ranges can be packed concurrently. words of Mono1 frame are ones plane as they are
+     * (zeros plane is their complement), no pixel byte is read.
+     * @param videoFrame(in): video frame to pack.
+     * @param firstRow(in): first row to pack.
+     * @param lastRow(in): end of rows to pack.
+     */
+    void packRows(const VideoFrame &videoFrame, size_t firstRow, size_t lastRow)
+    {
+        const PackRowKernel packRow = SimdKernels::active().m_packRow;
+        for (size_t y = firstRow; y < min(lastRow, m_height); y++)
+        {
+            uint64_t *ones = this->ones(y);
+            uint64_t *zeros = this->zeros(y);
+            if (videoFrame.format() == PixelFormat::Mono1)
+            {
+                const uint64_t *bits = videoFrame.bits(y);
+                for (size_t word = 0; word < m_wordsPerRow; word++)
+                {
+                    const uint64_t valid = bitRangeMask(word, 0, m_width);
+                    ones[word] = bits[word] & valid;
+                    zeros[word] = ~bits[word] & valid;
+                }
+            }
+            else
+            {
+                packRow(videoFrame.row(y).data(), m_width, ones, zeros);
+            }
+            ones[m_wordsPerRow] = 0;
+            zeros[m_wordsPerRow] = 0;
+        }
+    }
+
+    size_t width() const { return m_width; }
+    size_t height() const { return m_height; }
+    size_t wordsPerRow() const { return m_wordsPerRow; }
+    uint64_t* ones(size_t y) { return m_onesPlane.data() + y * (m_wordsPerRow + 1); }
+    uint64_t* zeros(size_t y) { return m_zerosPlane.data() + y * (m_wordsPerRow + 1); }
+    const uint64_t* ones(size_t y) const { return m_onesPlane.data() + y * (m_wordsPerRow + 1); }
+    const uint64_t* zeros(size_t y) const { return m_zerosPlane.data() + y * (m_wordsPerRow + 1); }
+
+    /**
+     * @brief planes description for row matches kernels.
+     * @return RowMatchArgs: planes part filled, pattern part left empty.
+     */
+    RowMatchArgs rowMatchArgs() const
+    {
+        return RowMatchArgs{m_onesPlane.data(), m_zerosPlane.data(), m_wordsPerRow + 1, m_wordsPerRow, nullptr, 0, 0};
+    }
+
+private:
+    size_t m_width; /**< width of packed frame. */
+    size_t m_height; /**< height of packed frame. */
+    size_t m_wordsPerRow; /**< number of 64 bits words covering width pixels. */
+    vector<uint64_t> m_onesPlane; /**< plane of pixels equal to 1. */
+    vector<uint64_t> m_zerosPlane; /**< plane of pixels equal to 0. */
+};
+
+/**
+ * @brief kinds of pattern matchers, Auto lets PatternMatcherRegistry choose fastest available one.
+ */
+enum class MatcherKind : int
+{
+    Auto = 0,    /**< fixed shape matcher when registered, else bitmask, else bytewise. */
+    Fixed = 1,   /**< compile time shape matcher (binary pattern of a registered shape). */
+    Bitmask = 2, /**< runtime shape bit planes matcher (binary pattern, at most 64 columns). */
+    Bytewise = 3, /**< runtime byte comparison (any pattern). */
+    SummedArea = 4 /**< byte comparison of windows having as many non zero pixels as pattern (summed area table prefilter, any pattern). */
+};
+
+/**
+ * @brief interface of pattern matchers used by detectors.
+ */
+class PatternMatcher
+{
+public:
+    virtual ~PatternMatcher() = default;
+
+    /**
+     * @brief tells if matcher works on bit planes, in which case caller packs frame before findAll.
+     * @return bool: true if findAll reads rows argument, false if it reads frame argument.
+     */
+    virtual bool usesPackedRows() const = 0;
+
+    /**
+     * @brief finds all positions of pattern with first row in [firstRow, lastRow).
+     * positions are appended in (y, x) increasing order.
+     * @param frame(in): video frame.
+     * @param rows(in): packed rows of frame (valid only if usesPackedRows()).
+     * @param firstRow(in): first candidate row.
+     * @param lastRow(in): end of candidate rows (clamped to height - pattern height + 1).
+     * @param positions(out): found positions.
+     */
+    virtual void findAll(const VideoFrame &frame, const PackedFrameRows &rows, size_t firstRow, size_t lastRow,
+                         vector<PatternPosition> &positions) const = 0;
+
+    /**
+     * @brief matcher description for logs (for example "fixed 4x3").
+     * @return string: description.
+     */
+    virtual string name() const = 0;
+
+    /**
+     * @brief checks if pattern is binary (0/1 pixels), rectangular, non empty with at most 64 columns.
+     * @param pattern(in): pattern to check.
+     * @return bool: true if pattern can be matched on bit planes.
+     */
+    static bool isBinary(const vector<vector<uint8_t>> &pattern)
+    {
+        if (pattern.empty() || pattern[0].empty() || (pattern[0].size() > 64))
+            return false;
+        return all_of(pattern.begin(), pattern.end(), [&pattern](const auto &raw) {
+            return (raw.size() == pattern[0].size()) &&
+                   all_of(raw.begin(), raw.end(), [](uint8_t pixel) { return pixel <= 1; });
+        });
+    }
+
+    /**
+     * @brief bits of pattern row : bit c set when pixel c is 1.
+     * @param raw(in): pattern row.
+     * @return uint64_t: row bits.
+     */
+    static uint64_t rowBits(const vector<uint8_t> &raw)
+    {
+        uint64_t bits = 0;
+        for (size_t c = 0; c < raw.size(); c++)
+            bits |= uint64_t(raw[c] == 1) << c;
+        return bits;
+    }
+};
+
+/**
+ * @brief word wide matcher of binary patterns (pixels 0/1, at most 64 columns).
+ * for a pattern row and a frame row, one word of 64 candidate positions is computed by
+ * AND of pattern width shifted plane words (ones plane for pattern 1 pixels, zeros plane
+ * for pattern 0 pixels). candidates of a window are AND of its rows words, a word is
+ * skipped as soon as no candidate remains. search runs on active SimdKernels.
+ */
+class BitmaskPatternMatcher: public PatternMatcher
+{
+public:
+    /**
+     * @brief BitmaskPatternMatcher constructor.
+     * @param pattern(in): binary pattern to match (see PatternMatcher::isBinary).
+     */
+    BitmaskPatternMatcher(const vector<vector<uint8_t>> &pattern) :
+            m_width(pattern[0].size()), m_height(pattern.size())
+    {
+        for (const auto &raw : pattern)
+            m_rowBits.push_back(rowBits(raw));
+    }
+
+    bool usesPackedRows() const override
+    {
+        return true;
+    }
+
+    void findAll(const VideoFrame &frame, const PackedFrameRows &rows, size_t firstRow, size_t lastRow,
+                 vector<PatternPosition> &positions) const override
+    {
+        (void)frame;
+        if ((rows.height() < m_height) || (rows.width() < m_width))
+            return;
+        lastRow = min(lastRow, rows.height() - m_height + 1);
+
+        RowMatchArgs args = rows.rowMatchArgs();
+        args.m_patternRows = m_rowBits.data();
+        args.m_patternWidth = m_width;
+        args.m_patternHeight = m_height;
+        const FindRowMatchesKernel findRowMatches = SimdKernels::active().m_findRowMatches;
+        for (size_t y = firstRow; y < lastRow; y++)
+            findRowMatches(args, y, positions);
+    }
+
+    string name() const override
+    {
+        return string("bitmask ") + to_string(m_height) + "x" + to_string(m_width) + " " +
+               SimdKernels::levelName(SimdKernels::active().m_level);
+    }
+
+private:
+    size_t m_width; /**< pattern width. */
+    size_t m_height; /**< pattern height. */
+    vector<uint64_t> m_rowBits; /**< bit c of row word set when pattern pixel (c, row) is 1. */
+};
+
+/**
+ * @brief bit planes matcher of binary patterns of shape known at compile time :
+ * rows and columns loops are expanded by fold expressions so that each candidates word is
+ * computed by Rows * Cols shifts by constants and ANDs without loop nor pattern reload.
+ * @tparam Rows: pattern height.
+ * @tparam Cols: pattern width (<= 64).
+ */
+template <size_t Rows, size_t Cols>
+class FixedPatternMatcher: public PatternMatcher
+{
+    static_assert((Rows > 0) && (Cols > 0) && (Cols <= 64), "fixed pattern shape must be in [1..N]x[1..64]");
+public:
+    /**
+     * @brief FixedPatternMatcher constructor.
+     * @param pattern(in): binary pattern of Rows x Cols pixels.
+     */
+    FixedPatternMatcher(const vector<vector<uint8_t>> &pattern)
+    {
+        if ((pattern.size() != Rows) || (pattern[0].size() != Cols))
+            throw invalid_argument("FixedPatternMatcher pattern shape mismatch");
+        for (size_t k = 0; k < Rows; k++)
+            m_rowBits[k] = rowBits(pattern[k]);
+    }
+
+    bool usesPackedRows() const override
+    {
+        return true;
+    }
+
+    void findAll(const VideoFrame &frame, const PackedFrameRows &rows, size_t firstRow, size_t lastRow,
+                 vector<PatternPosition> &positions) const override
+    {
+        (void)frame;
+        if ((rows.height() < Rows) || (rows.width() < Cols))
+            return;
+        lastRow = min(lastRow, rows.height() - Rows + 1);
+
+        array<const uint64_t*, Rows> planes[2];
+        for (size_t y = firstRow; y < lastRow; y++)
+        {
+            for (size_t k = 0; k < Rows; k++)
+            {
+                planes[0][k] = rows.zeros(y + k);
+                planes[1][k] = rows.ones(y + k);
+            }
+            for (size_t word = 0; word < rows.wordsPerRow(); word++)
+                ScalarKernels::appendCandidates(windowWord(planes, word, make_index_sequence<Rows>{}), word, y, positions);
+        }
+    }
+
+    string name() const override
+    {
+        return string("fixed ") + to_string(Rows) + "x" + to_string(Cols);
+    }
+
+private:
+    template <size_t... K>
+    uint64_t windowWord(const array<const uint64_t*, Rows> (&planes)[2], size_t word, index_sequence<K...>) const
+    {
+        return (rowWord<K>(planes, word, make_index_sequence<Cols>{}) & ...);
+    }
+
+    template <size_t K, size_t... C>
+    uint64_t rowWord(const array<const uint64_t*, Rows> (&planes)[2], size_t word, index_sequence<C...>) const
+    {
+        return (columnWord<C>(planes[(m_rowBits[K] >> C) & 1][K], word) & ...);
+    }
+
+    template <size_t C>
+    static uint64_t columnWord(const uint64_t *plane, size_t word)
+    {
+        if constexpr (C == 0)
+            return plane[word];
+        else
+            return (plane[word] >> C) | (plane[word + 1] << (64 - C));
+    }
+
+    array<uint64_t, Rows> m_rowBits; /**< bit c of row word set when pattern pixel (c, row) is 1. */
+};
+
+/**
+ * @brief matcher comparing frame rows in place with pattern rows byte by byte (any pixel values).
+ */
+class BytewisePatternMatcher: public PatternMatcher
+{
+public:
+    /**
+     * @brief BytewisePatternMatcher constructor.
+     * @param pattern(in): non empty rectangular pattern.
+     * @param prefilter(in): rejects in O(1) windows whose non zero pixels count differs from pattern
+     * one before comparing bytes (frame summed area table).
+     */
+    BytewisePatternMatcher(const vector<vector<uint8_t>> &pattern, bool prefilter = false) :
+            m_patternToDetect(pattern), m_prefilter(prefilter), m_nonZeroPixels(0)
+    {
+        for (const auto &row : pattern)
+            m_nonZeroPixels += static_cast<uint32_t>(count_if(row.begin(), row.end(), [](uint8_t pixel) { return pixel != 0; }));
+    }
+
+    bool usesPackedRows() const override
+    {
+        return false;
+    }
+
+    void findAll(const VideoFrame &frame, const PackedFrameRows &rows, size_t firstRow, size_t lastRow,
+                 vector<PatternPosition> &positions) const override
+    {
+        (void)rows;
+        const size_t patternHeight = m_patternToDetect.size();
+        const size_t patternWidth = m_patternToDetect[0].size();
+        if ((frame.m_height < patternHeight) || (frame.m_width < patternWidth))
+            return;
+        lastRow = min<size_t>(lastRow, frame.m_height - patternHeight + 1);
+        const SummedAreaTable *table = (m_prefilter && (firstRow < lastRow)) ?
+                                       &frame.summedAreaTable(lastRow + patternHeight - 1) : nullptr;
+
+        if (table)
+        {
+            findAllPrefiltered(frame, *table, firstRow, lastRow, positions);
+            return;
+        }
+
+        for (size_t j = firstRow; j < lastRow; j++)
+        {
+            // fix raw j from input frame video
+            auto raw = frame.row(j);
+            // loop in pixels of frame video raw to find first raw from pattern
+            for (size_t i = 0; i <= (raw.size() - patternWidth); i++)
+            {
+                bool found = equal(m_patternToDetect[0].begin(), m_patternToDetect[0].end(), raw.begin() + i);
+                // first raw found look to other raws from pattern in next raws from current frame video raw
+                // in same positions j for raw and i for pixel position
+                for (size_t k = 1; found && (k < patternHeight); k++)
+                {
+                    found = equal(m_patternToDetect[k].begin(), m_patternToDetect[k].end(), frame.row(j + k).begin() + i);
+                }
+
+                // all elements from pattern found in following position (j, i)
+                if (found)
+                    positions.push_back(PatternPosition{i, j});
+            }
+        }
+    }
+
+    string name() const override
+    {
+        return string(m_prefilter ? "summed area " : "bytewise ") + to_string(m_patternToDetect.size()) + "x" + to_string(m_patternToDetect[0].size());
+    }
+
+private:
+    /**
+     * @brief same as findAll with summed area table prefilter : for each row, columns of windows having
+     * pattern non zero pixels count are collected without branches (count is random on noisy frames),
+     * then only those windows are compared byte by byte.
+     */
+    void findAllPrefiltered(const VideoFrame &frame, const SummedAreaTable &table, size_t firstRow, size_t lastRow,
+                            vector<PatternPosition> &positions) const
+    {
+        const size_t patternHeight = m_patternToDetect.size();
+        const size_t patternWidth = m_patternToDetect[0].size();
+        const size_t windows = frame.m_width - patternWidth + 1;
+        static thread_local vector<uint32_t> candidates;
+        candidates.resize(windows);
+
+        for (size_t j = firstRow; j < lastRow; j++)
+        {
+            size_t count = 0;
+            for (size_t i = 0; i < windows; i++)
+            {
+                candidates[count] = static_cast<uint32_t>(i);
+                count += (table.count(i, j, patternWidth, patternHeight) == m_nonZeroPixels);
+            }
+            for (size_t c = 0; c < count; c++)
+            {
+                const size_t i = candidates[c];
+                bool found = true;
+                for (size_t k = 0; found && (k < patternHeight); k++)
+                {
+                    found = equal(m_patternToDetect[k].begin(), m_patternToDetect[k].end(), frame.row(j + k).begin() + i);
+                }
+                if (found)
+                    positions.push_back(PatternPosition{i, j});
+            }
+        }
+    }
+
+    vector<vector<uint8_t>> m_patternToDetect;/**< pattern to detect. */
+    bool m_prefilter;/**< true to reject windows with summed area table first. */
+    uint32_t m_nonZeroPixels;/**< non zero pixels count of pattern. */
+};
+
+/**
+ * @brief registry of compile time shape matchers : creates FixedPatternMatcher when a binary
+ * pattern has a registered shape, else falls back to runtime matchers.
+ * shapes 3x3, 3x4, 4x3, 4x4 and 5x5 are registered by default, others can be added with registerShape.
+ */
+class PatternMatcherRegistry
+{
+public:
+    using Factory = unique_ptr<PatternMatcher> (*)(const vector<vector<uint8_t>> &pattern);
+
+    /**
+     * @brief process wide registry.
+     * @return PatternMatcherRegistry: registry instance.
+     */
+    static PatternMatcherRegistry& instance()
+    {
+        static PatternMatcherRegistry registry;
+        return registry;
+    }
+
+    /**
+     * @brief instantiates and registers fixed matcher of shape Rows x Cols.
+     */
+    template <size_t Rows, size_t Cols>
+    void registerShape()
+    {
+        lock_guard<mutex> lock(m_lock);
+        m_factories[{Rows, Cols}] = [](const vector<vector<uint8_t>> &pattern) -> unique_ptr<PatternMatcher> {
+            return make_unique<FixedPatternMatcher<Rows, Cols>>(pattern);
+        };
+    }
+
+    /**
+     * @brief creates matcher of pattern.
+     * @param pattern(in): non empty rectangular pattern.
+     * @param kind(in): requested matcher kind, throws invalid_argument when it cannot match pattern.
+     * @return unique_ptr<PatternMatcher>: created matcher.
+     */
+    unique_ptr<PatternMatcher> create(const vector<vector<uint8_t>> &pattern, MatcherKind kind = MatcherKind::Auto) const
+    {
+        if (pattern.empty() || pattern[0].empty())
+            throw invalid_argument("pattern to detect is empty");
+        const bool binary = PatternMatcher::isBinary(pattern);
+        if ((kind == MatcherKind::Auto) || (kind == MatcherKind::Fixed))
+        {
+            Factory factory = nullptr;
+            {
+                lock_guard<mutex> lock(m_lock);
+                auto it = m_factories.find({pattern.size(), pattern[0].size()});
+                if (binary && (it != m_factories.end()))
+                    factory = it->second;
+            }
+            if (factory)
+                return factory(pattern);
+            if (kind == MatcherKind::Fixed)
+                throw invalid_argument("no fixed matcher registered for pattern shape");
+        }
+        if ((kind == MatcherKind::Auto) || (kind == MatcherKind::Bitmask))
+        {
+            if (binary)
+                return make_unique<BitmaskPatternMatcher>(pattern);
+            if (kind == MatcherKind::Bitmask)
+                throw invalid_argument("bitmask matcher needs binary pattern of at most 64 columns");
+        }
+        return make_unique<BytewisePatternMatcher>(pattern, kind == MatcherKind::SummedArea);
+    }
+
+private:
+    PatternMatcherRegistry()
+    {
+        registerShape<3, 3>();
+        registerShape<3, 4>();
+        registerShape<4, 3>();
+        registerShape<4, 4>();
+        registerShape<5, 5>();
+    }
+
+    mutable mutex m_lock; /**< protects factories. */
+    map<pair<size_t, size_t>, Factory> m_factories; /**< fixed matchers factories by (rows, cols) shape. */
+};
+
+/**
+ * @brief how detectors report found patterns in frames.
+ */
+enum class MarkingMode : int
+{
+    Overlay = 0, /**< a DetectionBox is added to frame overlay, pixels are left unchanged. */
+    Pixels = 1   /**< non zero pixels of match are changed to 2 in place (only safe when no other element reads frame concurrently). */
+};
+
+/**
+ * @brief which matches of a frame detectors look for and report.
+ */
+enum class DetectionMode : int
+{
+    All = 0,        /**< every match is logged and marked (see MarkingMode). */
+    FirstMatch = 1, /**< search stops at first match in (y, x) order, which is logged, frame is left unchanged (pattern presence alerts). */
+    CountOnly = 2,  /**< matches are counted and count is logged, frame is left unchanged. */
+    TopK = 3        /**< search stops once DetectorConfig::m_maxMatches matches are found in (y, x) order, they are logged and marked. */
+};
+
+/**
+ * @brief options of DetectorElement.
+ */
+struct DetectorConfig
+{
+    MatcherKind m_matcherKind = MatcherKind::Auto; /**< matcher to use, by default fastest one supporting pattern. */
+    ThreadPool *m_threadPool = nullptr; /**< pool used to scan bands of frame in parallel, null to scan in calling thread. */
+    size_t m_bandRows = 0; /**< candidate rows per band (0 : frame split in one band per pool thread + calling thread). */
+    MarkingMode m_markingMode = MarkingMode::Overlay; /**< how found patterns are reported in frame. */
+    bool m_reuseUnchangedMatches = true; /**< only search changed blocks of frames carrying changes against previous processed frame. */
+    DetectionMode m_detectionMode = DetectionMode::All; /**< which matches are searched and reported. */
+    size_t m_maxMatches = 1; /**< matches searched per frame in TopK mode (> 0). */
+};
+
+/**
+ * @brief counters of detector.
+ */
+struct DetectorStats
+{
+    uint64_t m_frames; /**< searched frames. */
+    uint64_t m_framesWithMatches; /**< searched frames with at least one match. */
+    uint64_t m_matches; /**< reported matches (bounded per frame in FirstMatch and TopK modes). */
+};
+
+/**
+ * @brief detector element to find specific patterns in frame rate and mark it
+ * for print (in frame overlay or with different pixels value, see MarkingMode).
+ * pattern matcher is chosen by PatternMatcherRegistry (compile time shape, bit planes or bytewise).
+ * with a thread pool, frame is split in horizontal bands scanned in parallel : each band owns
+ * candidate rows [first, last) and reads rows up to last + pattern height - 1, so consecutive
+ * bands overlap by pattern height - 1 rows. a match is reported only by band owning its first
+ * row which removes duplicates at band seams, positions stay in (y, x) order.
+ * when frame carries changes (see MotionDetectorElement) against previous processed frame, matches of
+ * previous frame in windows without changed block are kept and only rows of changed blocks rows are
+ * searched (Overlay marking mode only as Pixels mode alters reference pixels).
+ */
+class DetectorElement: public BaseElement
+{
+public:
+    /**
+     * @brief DetectorElement constructor.
+     * @param pattern(in): pattern to find inside/mark it inside video frame.
+     * @param config(in): detector options.
+     */
+    DetectorElement(const vector<vector<uint8_t>> &pattern, const DetectorConfig &config = DetectorConfig{}) :
+            m_patternToDetect(pattern),
+            m_matcher(PatternMatcherRegistry::instance().create(pattern, config.m_matcherKind)),
+            m_config(config), m_frames(0), m_framesWithMatches(0), m_matches(0)
+    {
+        if ((config.m_detectionMode == DetectionMode::TopK) && (config.m_maxMatches == 0))
+            throw invalid_argument("DetectorElement top k mode needs k > 0");
+        MD_LOG(LogLevel::Debug, "DetectorElement uses matcher : " << m_matcher->name()
+               << (m_config.m_threadPool ? " in parallel bands" : "") << "\n");
+    }
+
+    /**
+     * @brief DetectorElement Destructor.
+     */
+    ~DetectorElement()
+    {
+    }
+
+    /**
+     * @brief to process frame video in order to find and mark specified pattern.
+     * @param videoFrame(in): shared pointer of video frame.
+     * @return void.
+     */
+    void process(shared_ptr<VideoFrame> videoFrame) override
+    {
+        checkPatternAndMarkExistingPatterns(videoFrame);
+    }
+
+    /**
+     * @brief to process a batch of frames. with a thread pool, frames of batch are searched in
+     * parallel (one frame per task, each with its own bit planes and positions) instead of
+     * splitting each frame in bands, found patterns are then logged and marked in frames order.
+     * @param videoFrames(in): frames of batch.
+     * @return void.
+     */
+    void processBatch(FrameSpan videoFrames) override
+    {
+        if (!m_config.m_threadPool || (videoFrames.size() < 2))
+        {
+            for (const auto &videoFrame : videoFrames)
+                checkPatternAndMarkExistingPatterns(videoFrame);
+            return;
+        }
+
+        if (m_batchScratch.size() < videoFrames.size())
+            m_batchScratch.resize(videoFrames.size());
+        m_config.m_threadPool->parallelFor(videoFrames.size(), [this, &videoFrames](size_t index) {
+            FrameScratch &scratch = m_batchScratch[index];
+            scratch.m_positions.clear();
+            if (!fitsPattern(*videoFrames[index]))
+                return;
+            if (boundedSearch())
+                findFirst(*videoFrames[index], scratch.m_bytesFrame, scratch.m_packedRows, scratch.m_positions, matchLimit());
+            else
+                findAll(searchedFrame(*videoFrames[index], scratch.m_bytesFrame), scratch.m_packedRows, scratch.m_positions);
+        });
+        for (size_t index = 0; index < videoFrames.size(); index++)
+            if (fitsPattern(*videoFrames[index]))
+                reportMatches(videoFrames[index], m_batchScratch[index].m_positions);
+        rememberMatches(*videoFrames[videoFrames.size() - 1], m_batchScratch[videoFrames.size() - 1].m_positions);
+    }
+
+    /**
+     * @brief matcher used by detector.
+     * @return PatternMatcher.
+     */
+    const PatternMatcher& matcher() const
+    {
+        return *m_matcher;
+    }
+
+    /**
+     * @brief snapshot of detector counters.
+     * @return DetectorStats.
+     */
+    DetectorStats stats() const
+    {
+        return DetectorStats{m_frames.load(memory_order_relaxed), m_framesWithMatches.load(memory_order_relaxed),
+                             m_matches.load(memory_order_relaxed)};
+    }
+
+    static constexpr size_t kBoundedSearchRows = 16; /**< candidate rows searched (and packed) per step of FirstMatch and TopK modes. */
+
+private:
+
+    /**
+     * @brief once pattern found this method adds its box to frame overlay or, in Pixels marking
+     * mode, alters values of pattern to change them from 1 to 2 (note that 0 pixels of found
+     * pattern remains unchanged), 1 pixels of Mono1 frame are flagged in its match mask instead.
+     * @param videoFrame(in): shared pointer of video frame.
+     * @param xPosition(in): x position of found pattern.
+     * @param yPosition(in): y position of found pattern.
+     * @return void.
+     */
+    void markPattern(shared_ptr<VideoFrame> videoFrame, size_t xPosition, size_t yPosition)
+    {
+        if (m_config.m_markingMode == MarkingMode::Overlay)
+        {
+            videoFrame->m_overlay.add(DetectionBox{static_cast<uint32_t>(xPosition), static_cast<uint32_t>(yPosition),
+                                                   static_cast<uint32_t>(m_patternToDetect[0].size()),
+                                                   static_cast<uint32_t>(m_patternToDetect.size())});
+            return;
+        }
+
+        const MarkRowKernel markRow = SimdKernels::active().m_markRow;
+        for (auto k = yPosition; k < (yPosition + m_patternToDetect.size()); k++)
+        {
+            if (videoFrame->format() == PixelFormat::Mono1)
+                videoFrame->markMatch(xPosition, k, m_patternToDetect[0].size());
+            else
+                markRow(videoFrame->row(k).data() + xPosition, m_patternToDetect[0].size());
+        }
+        if (videoFrame->m_changes.m_valid)
+            videoFrame->m_changes.addDirtyRegion(DetectionBox{static_cast<uint32_t>(xPosition), static_cast<uint32_t>(yPosition),
+                                                              static_cast<uint32_t>(m_patternToDetect[0].size()),
+                                                              static_cast<uint32_t>(m_patternToDetect.size())});
+    }
+
+    /**
+     * @brief Checks all occurrences of pattern in a video frame (or first ones, see DetectionMode).
+     * frame is never copied, found positions are collected first and marked once whole frame
+     * is scanned so that marking does not alter overlapping matches.
+     * all found patterns are marked (see markPattern method.) but in FirstMatch and CountOnly modes.
+     * @param videoFrame(in): shared pointer of video frame.
+     * @return void.
+     */
+    void checkPatternAndMarkExistingPatterns(shared_ptr<VideoFrame> videoFrame)
+    {
+        const VideoFrame &frame = *videoFrame;
+
+        if (!fitsPattern(frame))
+        {
+            return;
+        }
+
+        m_foundPositions.clear();
+        if (boundedSearch())
+        {
+            findFirst(frame, m_bytesFrame, m_packedRows, m_foundPositions, matchLimit());
+        }
+        else if (canReusePreviousMatches(frame))
+        {
+            findAllInChangedRows(searchedFrame(frame, m_bytesFrame), frame.m_changes);
+        }
+        else if (m_config.m_threadPool)
+        {
+            findAllInBands(searchedFrame(frame, m_bytesFrame));
+        }
+        else
+        {
+            findAll(searchedFrame(frame, m_bytesFrame), m_packedRows, m_foundPositions);
+        }
+
+        rememberMatches(frame, m_foundPositions);
+        reportMatches(videoFrame, m_foundPositions);
+    }
+
+    /**
+     * @brief checks if search stops after first matches (FirstMatch and TopK modes).
+     * @return bool: true if search is bounded by matchLimit.
+     */
+    bool boundedSearch() const
+    {
+        return (m_config.m_detectionMode == DetectionMode::FirstMatch) || (m_config.m_detectionMode == DetectionMode::TopK);
+    }
+
+    /**
+     * @brief max matches of a bounded search.
+     * @return size_t: 1 in FirstMatch mode, k in TopK mode.
+     */
+    size_t matchLimit() const
+    {
+        return (m_config.m_detectionMode == DetectionMode::TopK) ? m_config.m_maxMatches : 1;
+    }
+
+    /**
+     * @brief finds first occurrences of pattern in (y, x) order : candidate rows are packed (or
+     * converted to Gray8, see searchedFrame) and searched kBoundedSearchRows at a time, search stops
+     * once limit matches are found.
+     * @param frame(in): video frame.
+     * @param bytesFrame(in/out): Gray8 frame reused for conversions.
+     * @param packedRows(in/out): bit planes storage for frame.
+     * @param positions(out): at most limit found positions.
+     * @param limit(in): max number of positions.
+     */
+    void findFirst(const VideoFrame &frame, unique_ptr<VideoFrame> &bytesFrame, PackedFrameRows &packedRows,
+                   vector<PatternPosition> &positions, size_t limit) const
+    {
+        const VideoFrame &searched = searchedFrame(frame, bytesFrame, false);
+        const bool convertsRows = (&searched != &frame);
+        const size_t patternHeight = m_patternToDetect.size();
+        const size_t candidateRows = frame.m_height - patternHeight + 1;
+        if (m_matcher->usesPackedRows())
+            packedRows.resize(frame);
+        size_t readyRowsEnd = 0;
+        for (size_t first = 0; (first < candidateRows) && (positions.size() < limit); first += kBoundedSearchRows)
+        {
+            const size_t last = min(candidateRows, first + kBoundedSearchRows);
+            if (m_matcher->usesPackedRows())
+                packedRows.packRows(frame, readyRowsEnd, last + patternHeight - 1);
+            else if (convertsRows)
+                bytesFrame->convertRows(frame, readyRowsEnd, last + patternHeight - 1);
+            readyRowsEnd = last + patternHeight - 1;
+            m_matcher->findAll(searched, packedRows, first, last, positions);
+        }
+        if (positions.size() > limit)
+            positions.resize(limit);
+    }
+
+    /**
+     * @brief counts, logs and marks (according to detection mode) found patterns of a frame.
+     * @param videoFrame(in): shared pointer of video frame.
+     * @param positions(in): found positions.
+     */
+    void reportMatches(shared_ptr<VideoFrame> videoFrame, const vector<PatternPosition> &positions)
+    {
+        m_frames.fetch_add(1, memory_order_relaxed);
+        m_matches.fetch_add(positions.size(), memory_order_relaxed);
+        if (positions.empty())
+            return;
+        m_framesWithMatches.fetch_add(1, memory_order_relaxed);
+        if (m_config.m_detectionMode == DetectionMode::FirstMatch)
+        {
+            MD_LOG(LogLevel::Info, "***** PATTERN FOUND AT POSITION j : " << positions[0].m_y << " i : " << positions[0].m_x << " ******\n");
+            return;
+        }
+        if (m_config.m_detectionMode == DetectionMode::CountOnly)
+        {
+            MD_LOG(LogLevel::Info, "***** PATTERN FOUND " << positions.size() << " TIMES IN FRAME " << videoFrame->m_sequenceNumber << " ******\n");
+            return;
+        }
+        markFoundPatterns(videoFrame, positions);
+    }
+
+    /**
+     * @brief checks if changes of frame are relative to previous processed frame.
+     * @param frame(in): video frame.
+     * @return bool: true if matches of unchanged windows of previous frame can be reused.
+     */
+    bool canReusePreviousMatches(const VideoFrame &frame) const
+    {
+        return m_config.m_reuseUnchangedMatches &&
+               ((m_config.m_markingMode == MarkingMode::Overlay) || (m_config.m_detectionMode == DetectionMode::CountOnly)) &&
+               m_previous.m_valid && frame.m_changes.m_valid && (frame.m_changes.m_referenceSequence == m_previous.m_sequence) &&
+               (frame.m_width == m_previous.m_width) && (frame.m_height == m_previous.m_height);
+    }
+
+    /**
+     * @brief keeps matches of processed frame for next frame.
+     * @param frame(in): processed video frame.
+     * @param positions(in): all matches of frame.
+     */
+    void rememberMatches(const VideoFrame &frame, const vector<PatternPosition> &positions)
+    {
+        // first matches of a bounded search are not all matches of frame
+        m_previous.m_valid = !boundedSearch();
+        m_previous.m_sequence = frame.m_sequenceNumber;
+        m_previous.m_width = frame.m_width;
+        m_previous.m_height = frame.m_height;
+        m_previous.m_positions.assign(positions.begin(), positions.end());
+    }
+
+    /**
+     * @brief finds all occurrences of pattern reusing matches of previous frame : previous matches of
+     * windows without changed block are kept, candidate rows of windows overlapping a changed rows of
+     * blocks are searched and only their matches overlapping a changed block are added.
+     * @param frame(in): video frame (see searchedFrame).
+     * @param changes(in): changes of frame compared to previous processed frame.
+     */
+    void findAllInChangedRows(const VideoFrame &frame, const FrameChanges &changes)
+    {
+        const size_t patternHeight = m_patternToDetect.size();
+        const size_t patternWidth = m_patternToDetect[0].size();
+        const size_t candidateRows = frame.m_height - patternHeight + 1;
+
+        for (const auto &position : m_previous.m_positions)
+            if (!changes.isWindowDirty(position.m_x, position.m_y, patternWidth, patternHeight))
+                m_foundPositions.push_back(position);
+
+        if (m_matcher->usesPackedRows())
+            m_packedRows.resize(frame);
+        m_changedPositions.clear();
+        for (size_t row = 0; row < changes.m_blockRows; row++)
+        {
+            if (!changes.isRowDirty(row))
+                continue;
+            // windows overlapping this rows of blocks (merged with following dirty rows of blocks)
+            const size_t first = (row * changes.m_blockHeight >= patternHeight - 1) ? row * changes.m_blockHeight - (patternHeight - 1) : 0;
+            while ((row + 1 < changes.m_blockRows) && changes.isRowDirty(row + 1))
+                row++;
+            const size_t last = min(candidateRows, (row + 1) * changes.m_blockHeight);
+            if (first >= last)
+                continue;
+            if (m_matcher->usesPackedRows())
+                m_packedRows.packRows(frame, first, last + patternHeight - 1);
+            m_matcher->findAll(frame, m_packedRows, first, last, m_changedPositions);
+        }
+
+        for (const auto &position : m_changedPositions)
+            if (changes.isWindowDirty(position.m_x, position.m_y, patternWidth, patternHeight))
+                m_foundPositions.push_back(position);
+        sort(m_foundPositions.begin(), m_foundPositions.end(), [](const PatternPosition &a, const PatternPosition &b) {
+            return (a.m_y < b.m_y) || ((a.m_y == b.m_y) && (a.m_x < b.m_x));
+        });
+    }
+
+    /**
+     * @brief frame given to matcher : matchers reading bytes (see PatternMatcher::usesPackedRows) search
+     * a Gray8 conversion of a Mono1 frame, other ones search frame itself.
+     * @param frame(in): video frame.
+     * @param bytesFrame(in/out): Gray8 frame reused for conversions.
+     * @param convert(in): false to let caller convert rows by bands (see VideoFrame::convertRows).
+     * @return VideoFrame: frame to search.
+     */
+    const VideoFrame& searchedFrame(const VideoFrame &frame, unique_ptr<VideoFrame> &bytesFrame, bool convert = true) const
+    {
+        if (m_matcher->usesPackedRows() || (frame.format() == PixelFormat::Gray8))
+            return frame;
+        if (!bytesFrame || (bytesFrame->m_width != frame.m_width) || (bytesFrame->m_height != frame.m_height))
+            bytesFrame = make_unique<VideoFrame>(frame.m_width, frame.m_height);
+        if (convert)
+            bytesFrame->convertPixels(frame);
+        else
+            bytesFrame->invalidateSummedAreaTable();
+        return *bytesFrame;
+    }
+
+    /**
+     * @brief checks if width or height of pattern bigger then video frame which means pattern cannot be found.
+     * @param frame(in): video frame.
+     * @return bool: true when pattern fits in frame.
+     */
+    bool fitsPattern(const VideoFrame &frame) const
+    {
+        return (frame.m_height >= m_patternToDetect.size()) && (frame.m_width >= m_patternToDetect[0].size());
+    }
+
+    /**
+     * @brief finds all occurrences of pattern in whole frame on calling thread.
+     * @param frame(in): video frame.
+     * @param packedRows(in/out): bit planes storage for frame.
+     * @param positions(out): found positions are appended.
+     */
+    void findAll(const VideoFrame &frame, PackedFrameRows &packedRows, vector<PatternPosition> &positions) const
+    {
+        if (m_matcher->usesPackedRows())
+            packedRows.pack(frame);
+        m_matcher->findAll(frame, packedRows, 0, frame.m_height, positions);
+    }
+
+    /**
+     * @brief logs and marks found patterns of a frame.
+     * @param videoFrame(in): shared pointer of video frame.
+     * @param positions(in): found positions.
+     */
+    void markFoundPatterns(shared_ptr<VideoFrame> videoFrame, const vector<PatternPosition> &positions)
+    {
+        for (const auto &position : positions)
+        {
+            MD_LOG(LogLevel::Info, "***** PATTERN FOUND AT POSITION j : " << position.m_y << " i : " << position.m_x << " ******\n");
+            // mark pattern for display with '$'
+            markPattern(videoFrame, position.m_x, position.m_y);
+        }
+    }
+
+    /**
+     * @brief finds all occurrences of pattern scanning bands of frame in parallel on thread pool.
+     * frame rows are packed in parallel first (disjoint rows per band), then each band searches its
+     * candidate rows in its own positions vector, vectors are concatenated in bands order.
+     * @param frame(in): video frame.
+     */
+    void findAllInBands(const VideoFrame &frame)
+    {
+        const size_t candidateRows = frame.m_height - m_patternToDetect.size() + 1;
+        const size_t bandRows = m_config.m_bandRows ? m_config.m_bandRows :
+                                (candidateRows + m_config.m_threadPool->size()) / (m_config.m_threadPool->size() + 1);
+        const size_t bands = (candidateRows + bandRows - 1) / bandRows;
+        if (m_bandPositions.size() < bands)
+            m_bandPositions.resize(bands);
+
+        if (m_matcher->usesPackedRows())
+        {
+            m_packedRows.resize(frame);
+            const size_t packRows = (frame.m_height + bands - 1) / bands;
+            m_config.m_threadPool->parallelFor(bands, [this, &frame, packRows](size_t band) {
+                m_packedRows.packRows(frame, band * packRows, (band + 1) * packRows);
+            });
+        }
+
+        m_config.m_threadPool->parallelFor(bands, [this, &frame, bandRows](size_t band) {
+            m_bandPositions[band].clear();
+            m_matcher->findAll(frame, m_packedRows, band * bandRows, (band + 1) * bandRows, m_bandPositions[band]);
+        });
+
+        for (size_t band = 0; band < bands; band++)
+            m_foundPositions.insert(m_foundPositions.end(), m_bandPositions[band].begin(), m_bandPositions[band].end());
+    }
+
+    vector<vector<uint8_t>> m_patternToDetect;/**< pattern to detect. */
+    unique_ptr<PatternMatcher> m_matcher;/**< matcher of pattern. */
+    DetectorConfig m_config;/**< detector options. */
+    PackedFrameRows m_packedRows;/**< bit planes of current frame, kept to reuse its capacity. */
+    unique_ptr<VideoFrame> m_bytesFrame;/**< Gray8 conversion of current Mono1 frame (see searchedFrame). */
+    vector<PatternPosition> m_foundPositions;/**< positions found in current frame, kept to reuse its capacity. */
+    vector<vector<PatternPosition>> m_bandPositions;/**< positions found by each band, kept to reuse its capacity. */
+    atomic<uint64_t> m_frames;/**< see DetectorStats. */
+    atomic<uint64_t> m_framesWithMatches;/**< see DetectorStats. */
+    atomic<uint64_t> m_matches;/**< see DetectorStats. */
+
+    /**
+     * @brief search storage of one frame of a batch.
+     */
+    struct FrameScratch
+    {
+        PackedFrameRows m_packedRows; /**< bit planes of frame. */
+        unique_ptr<VideoFrame> m_bytesFrame; /**< Gray8 conversion of a Mono1 frame. */
+        vector<PatternPosition> m_positions; /**< positions found in frame. */
+    };
+    vector<FrameScratch> m_batchScratch;/**< storage of each frame of current batch, kept to reuse its capacity. */
+
+    /**
+     * @brief matches of previous processed frame.
+     */
+    struct PreviousMatches
+    {
+        bool m_valid = false; /**< true once a frame is processed. */
+        uint64_t m_sequence = 0; /**< sequence number of frame. */
+        uint32_t m_width = 0; /**< width of frame. */
+        uint32_t m_height = 0; /**< height of frame. */
+        vector<PatternPosition> m_positions; /**< all matches of frame. */
+    };
+    PreviousMatches m_previous;/**< matches of previous processed frame, reused for unchanged windows. */
+    vector<PatternPosition> m_changedPositions;/**< positions found in changed rows, kept to reuse its capacity. */
+};
+
+/**
+ * @brief pattern found by multi pattern detection.
+ */
+struct PatternMatch
+{
+    size_t m_patternId; /**< index of pattern in detector patterns list. */
+    PatternPosition m_position; /**< position of pattern in frame. */
+};
+
+/**
+ * @brief combined index of several patterns matched in one traversal of frame (in the spirit
+ * of Baker-Bird) : distinct rows of all binary patterns (same width and same bits) get one row
+ * id, so that 64 positions row matches words of a frame row are computed once per row id
+ * whatever number of patterns share it. patterns are stored in a trie of row ids : root
+ * children group patterns by first row signature, deeper nodes by common rows prefix. for a
+ * candidate row, candidates words of all positions are propagated down trie and a whole
+ * subtree is skipped as soon as its rows prefix no longer matches anywhere in row. cost grows with number of
+ * distinct rows and of matching prefixes rather than with number of patterns.
+ * non binary patterns (see PatternMatcher::isBinary) are matched separately byte by byte.
+ */
+class MultiPatternMatcher
+{
+public:
+    /**
+     * @brief MultiPatternMatcher constructor.
+     * @param patterns(in): non empty rectangular patterns, pattern id is index in this list.
+     */
+    MultiPatternMatcher(const vector<vector<vector<uint8_t>>> &patterns) :
+            m_maxHeight(0), m_wordsPerRow(0), m_nodes(1)
+    {
+        map<pair<size_t, uint64_t>, size_t> rowIds;
+        for (size_t id = 0; id < patterns.size(); id++)
+        {
+            const auto &pattern = patterns[id];
+            if (pattern.empty() || pattern[0].empty())
+                throw invalid_argument("pattern to detect is empty");
+            if (!PatternMatcher::isBinary(pattern))
+            {
+                m_bytewisePatterns.push_back({id, make_unique<BytewisePatternMatcher>(pattern)});
+                continue;
+            }
+
+            size_t node = 0;
+            for (size_t k = 0; k < pattern.size(); k++)
+            {
+                auto inserted = rowIds.emplace(make_pair(pattern[k].size(), PatternMatcher::rowBits(pattern[k])), m_rows.size());
+                if (inserted.second)
+                    m_rows.push_back(IndexedRow{pattern[k].size(), inserted.first->first.second});
+                node = childNode(node, inserted.first->second, k);
+            }
+            m_nodes[node].m_patternIds.push_back(id);
+            m_maxHeight = max(m_maxHeight, pattern.size());
+        }
+    }
+
+    /**
+     * @brief finds all positions of all patterns with first row in [firstRow, lastRow).
+     * binary patterns matches are appended in (y, x, pattern id) increasing order, then
+     * matches of non binary patterns.
+     * @param frame(in): video frame (read only by non binary patterns).
+     * @param rows(in): packed rows of frame.
+     * @param firstRow(in): first candidate row.
+     * @param lastRow(in): end of candidate rows.
+     * @param matches(out): found matches.
+     */
+    void findAll(const VideoFrame &frame, const PackedFrameRows &rows, size_t firstRow, size_t lastRow,
+                 vector<PatternMatch> &matches)
+    {
+        lastRow = min(lastRow, rows.height());
+        m_wordsPerRow = rows.wordsPerRow();
+        m_rowMatches.resize(m_maxHeight * m_rows.size() * m_wordsPerRow);
+        m_slotRows.assign(m_maxHeight * m_rows.size(), kNotComputed);
+
+        m_candidates.resize((m_maxHeight + 1) * m_wordsPerRow);
+        fill(m_candidates.begin(), m_candidates.begin() + m_wordsPerRow, ~uint64_t(0));
+
+        for (size_t y = firstRow; y < lastRow; y++)
+        {
+            const size_t firstMatch = matches.size();
+            visitChildren(rows, 0, y, matches);
+            sort(matches.begin() + firstMatch, matches.end(), [](const PatternMatch &a, const PatternMatch &b) {
+                return (a.m_position.m_x != b.m_position.m_x) ? (a.m_position.m_x < b.m_position.m_x) : (a.m_patternId < b.m_patternId);
+            });
+        }
+
+        for (const auto &bytewise : m_bytewisePatterns)
+        {
+            m_bytewisePositions.clear();
+            bytewise.second->findAll(frame, rows, firstRow, lastRow, m_bytewisePositions);
+            for (const auto &position : m_bytewisePositions)
+                matches.push_back(PatternMatch{bytewise.first, position});
+        }
+    }
+
+    /**
+     * @brief checks if some patterns are matched byte by byte (non binary patterns).
+     * @return bool: true if findAll reads bytes of frame.
+     */
+    bool hasBytewisePatterns() const
+    {
+        return !m_bytewisePatterns.empty();
+    }
+
+    /**
+     * @brief number of distinct rows in index (shared by all binary patterns).
+     * @return size_t: distinct rows count.
+     */
+    size_t distinctRows() const
+    {
+        return m_rows.size();
+    }
+
+    /**
+     * @brief number of first row groups in index (children of trie root).
+     * @return size_t: groups count.
+     */
+    size_t groups() const
+    {
+        return m_nodes[0].m_children.size();
+    }
+
+private:
+    static constexpr size_t kNotComputed = ~size_t(0); /**< marks a row matches slot not yet computed. */
+
+    /**
+     * @brief distinct pattern row.
+     */
+    struct IndexedRow
+    {
+        size_t m_width; /**< row width. */
+        uint64_t m_bits; /**< bit c set when pixel c is 1. */
+    };
+
+    /**
+     * @brief trie node : rows prefix shared by patterns, root (index 0) is empty prefix.
+     */
+    struct TrieNode
+    {
+        size_t m_rowId; /**< row id of last row of prefix. */
+        size_t m_depth; /**< index of last row of prefix in pattern. */
+        vector<size_t> m_children; /**< nodes extending prefix by one row. */
+        vector<size_t> m_patternIds; /**< patterns made of exactly this prefix. */
+    };
+
+    /**
+     * @brief finds or creates child of node for row id.
+     * @return size_t: child node index.
+     */
+    size_t childNode(size_t node, size_t rowId, size_t depth)
+    {
+        for (const auto child : m_nodes[node].m_children)
+        {
+            if (m_nodes[child].m_rowId == rowId)
+                return child;
+        }
+        m_nodes.push_back(TrieNode{rowId, depth, {}, {}});
+        m_nodes[node].m_children.push_back(m_nodes.size() - 1);
+        return m_nodes.size() - 1;
+    }
+
+    /**
+     * @brief row matches words of a row id in frame row y, computed once per (y, row id) : slots
+     * of m_maxHeight frame rows are reused as y advances.
+     * @param rows(in): packed rows of frame.
+     * @param y(in): frame row.
+     * @param rowId(in): distinct row id.
+     * @return const uint64_t*: m_wordsPerRow words, bit b of word w set when row matches at x = w * 64 + b.
+     */
+    const uint64_t* rowMatches(const PackedFrameRows &rows, size_t y, size_t rowId)
+    {
+        const size_t slot = (y % m_maxHeight) * m_rows.size() + rowId;
+        uint64_t *words = m_rowMatches.data() + slot * m_wordsPerRow;
+        if (m_slotRows[slot] == y)
+            return words;
+
+        const uint64_t *ones = rows.ones(y);
+        const uint64_t *zeros = rows.zeros(y);
+        const IndexedRow &row = m_rows[rowId];
+        for (size_t word = 0; word < m_wordsPerRow; word++)
+        {
+            uint64_t match = ~uint64_t(0);
+            for (unsigned c = 0; (c < row.m_width) && match; c++)
+                match &= ScalarKernels::shiftedWord(((row.m_bits >> c) & 1) ? ones : zeros, word, c);
+            words[word] = match;
+        }
+        m_slotRows[slot] = y;
+        return words;
+    }
+
+    /**
+     * @brief propagates candidates of a trie node (m_candidates words of its depth) to its children :
+     * child candidates are AND of parent candidates and row matches of child row, a child whose
+     * candidates words are all zero is skipped with its subtree.
+     * @param rows(in): packed rows of frame.
+     * @param node(in): trie node whose candidates are computed.
+     * @param y(in): candidate frame row (first row of patterns).
+     * @param matches(out): found matches.
+     */
+    void visitChildren(const PackedFrameRows &rows, size_t node, size_t y, vector<PatternMatch> &matches)
+    {
+        for (const auto child : m_nodes[node].m_children)
+        {
+            const TrieNode &childNode = m_nodes[child];
+            if ((y + childNode.m_depth >= rows.height()) || (m_rows[childNode.m_rowId].m_width > rows.width()))
+                continue;
+
+            const uint64_t *parent = m_candidates.data() + childNode.m_depth * m_wordsPerRow;
+            uint64_t *candidates = m_candidates.data() + (childNode.m_depth + 1) * m_wordsPerRow;
+            const uint64_t *matchWords = rowMatches(rows, y + childNode.m_depth, childNode.m_rowId);
+            uint64_t any = 0;
+            for (size_t word = 0; word < m_wordsPerRow; word++)
+            {
+                candidates[word] = parent[word] & matchWords[word];
+                any |= candidates[word];
+            }
+            if (any == 0)
+                continue;
+
+            for (const auto patternId : childNode.m_patternIds)
+            {
+                for (size_t word = 0; word < m_wordsPerRow; word++)
+                {
+                    uint64_t bits = candidates[word];
+                    while (bits)
+                    {
+                        matches.push_back(PatternMatch{patternId, PatternPosition{word * 64 + __builtin_ctzll(bits), y}});
+                        bits &= bits - 1;
+                    }
+                }
+            }
+            visitChildren(rows, child, y, matches);
+        }
+    }
+
+    size_t m_maxHeight; /**< height of highest binary pattern. */
+    size_t m_wordsPerRow; /**< words per frame row of current frame. */
+    vector<IndexedRow> m_rows; /**< distinct rows of binary patterns. */
+    vector<TrieNode> m_nodes; /**< trie of binary patterns rows, node 0 is root. */
+    vector<pair<size_t, unique_ptr<BytewisePatternMatcher>>> m_bytewisePatterns; /**< (pattern id, matcher) of non binary patterns. */
+    vector<uint64_t> m_rowMatches; /**< row matches words of m_maxHeight frame rows slots for each row id. */
+    vector<size_t> m_slotRows; /**< frame row computed in each slot. */
+    vector<uint64_t> m_candidates; /**< candidates words of current trie path, one row of words per depth. */
+    vector<PatternPosition> m_bytewisePositions; /**< positions found by a bytewise matcher. */
+};
+
+/**
+ * @brief detector element to find several patterns in one pass over frame (see MultiPatternMatcher)
+ * and mark them for print like DetectorElement.
+ */
+class MultiPatternDetectorElement: public BaseElement
+{
+public:
+    /**
+     * @brief MultiPatternDetectorElement constructor.
+     * @param patterns(in): patterns to find, pattern id reported in logs is index in this list.
+     * @param markingMode(in): how found patterns are reported in frame.
+     */
+    MultiPatternDetectorElement(const vector<vector<vector<uint8_t>>> &patterns, MarkingMode markingMode = MarkingMode::Overlay) :
+            m_patternsToDetect(patterns), m_matcher(patterns), m_markingMode(markingMode)
+    {
+        MD_LOG(LogLevel::Debug, "MultiPatternDetectorElement : " << patterns.size() << " patterns, "
+               << m_matcher.distinctRows() << " distinct rows, " << m_matcher.groups() << " first row groups\n");
+    }
+
+    /**
+     * @brief MultiPatternDetectorElement destructor.
+     */
+    ~MultiPatternDetectorElement()
+    {
+    }
+
+    /**
+     * @brief to process frame video in order to find and mark all patterns.
+     * @param videoFrame(in): shared pointer of video frame.
+     * @return void.
+     */
+    void process(shared_ptr<VideoFrame> videoFrame) override
+    {
+        checkPatternsAndMarkExistingPatterns(videoFrame);
+    }
+
+    /**
+     * @brief matches found in last processed frame.
+     * @return vector<PatternMatch>: matches.
+     */
+    const vector<PatternMatch>& lastMatches() const
+    {
+        return m_foundMatches;
+    }
+
+private:
+    /**
+     * @brief finds all patterns in one traversal then marks found patterns (see DetectorElement).
+     * @param videoFrame(in): shared pointer of video frame.
+     */
+    void checkPatternsAndMarkExistingPatterns(shared_ptr<VideoFrame> videoFrame)
+    {
+        m_foundMatches.clear();
+        m_packedRows.pack(*videoFrame);
+        const VideoFrame *searched = videoFrame.get();
+        if (m_matcher.hasBytewisePatterns() && (videoFrame->format() != PixelFormat::Gray8))
+        {
+            // non binary patterns read bytes of a Gray8 conversion of frame
+            if (!m_bytesFrame || (m_bytesFrame->m_width != videoFrame->m_width) || (m_bytesFrame->m_height != videoFrame->m_height))
+                m_bytesFrame = make_unique<VideoFrame>(videoFrame->m_width, videoFrame->m_height);
+            m_bytesFrame->convertPixels(*videoFrame);
+            searched = m_bytesFrame.get();
+        }
+        m_matcher.findAll(*searched, m_packedRows, 0, videoFrame->m_height, m_foundMatches);
+
+        const MarkRowKernel markRow = SimdKernels::active().m_markRow;
+        for (const auto &match : m_foundMatches)
+        {
+            const auto &pattern = m_patternsToDetect[match.m_patternId];
+            MD_LOG(LogLevel::Info, "***** PATTERN " << match.m_patternId << " FOUND AT POSITION j : " << match.m_position.m_y
+                   << " i : " << match.m_position.m_x << " ******\n");
+            if (m_markingMode == MarkingMode::Overlay)
+            {
+                videoFrame->m_overlay.add(DetectionBox{static_cast<uint32_t>(match.m_position.m_x), static_cast<uint32_t>(match.m_position.m_y),
+                                                       static_cast<uint32_t>(pattern[0].size()), static_cast<uint32_t>(pattern.size()),
+                                                       static_cast<uint32_t>(match.m_patternId)});
+                continue;
+            }
+            for (size_t k = match.m_position.m_y; k < match.m_position.m_y + pattern.size(); k++)
+            {
+                if (videoFrame->format() == PixelFormat::Mono1)
+                    videoFrame->markMatch(match.m_position.m_x, k, pattern[0].size());
+                else
+                    markRow(videoFrame->row(k).data() + match.m_position.m_x, pattern[0].size());
+            }
+            if (videoFrame->m_changes.m_valid)
+                videoFrame->m_changes.addDirtyRegion(DetectionBox{static_cast<uint32_t>(match.m_position.m_x), static_cast<uint32_t>(match.m_position.m_y),
+                                                                  static_cast<uint32_t>(pattern[0].size()), static_cast<uint32_t>(pattern.size())});
+        }
+    }
+
+    vector<vector<vector<uint8_t>>> m_patternsToDetect; /**< patterns to detect. */
+    MultiPatternMatcher m_matcher; /**< combined index of patterns. */
+    PackedFrameRows m_packedRows; /**< bit planes of current frame, kept to reuse its capacity. */
+    unique_ptr<VideoFrame> m_bytesFrame; /**< Gray8 conversion of current Mono1 frame for non binary patterns. */
+    vector<PatternMatch> m_foundMatches; /**< matches found in current frame, kept to reuse its capacity. */
+    MarkingMode m_markingMode; /**< how found patterns are reported in frame. */
+};
+
+/**
+ * @brief options of MotionDetectorElement.
+ */
+struct MotionDetectorConfig
+{
+    size_t m_historySize = 3; /**< number of last comparisons with changed blocks reaching threshold to report motion (>= 1). */
+    size_t m_blockWidth = FrameChanges::kDefaultBlockWidth; /**< columns of a block. */
+    size_t m_blockHeight = FrameChanges::kDefaultBlockHeight; /**< rows of a block. */
+    size_t m_minChangedBlocks = 1; /**< changed blocks from one frame to next one to consider frame as moving. */
+};
+
+/**
+ * @brief detector element of motion across frames : frame is compared block by block with previous
+ * frame, resulting changed blocks are stored in frame changes (VideoFrame::m_changes) for downstream
+ * elements, for instance DetectorElement searches changed blocks only. motion is reported once
+ * changed blocks count reaches threshold for each of the last history size comparisons (motion
+ * lasting history size frames), only counts of blocks are kept for them.
+ * this element writes frame metadata : it has to be placed in pipeline before elements (and
+ * branches) reading frame changes. previous frame is not recycled by frame pool until next frame
+ * is processed.
+ */
+class MotionDetectorElement: public BaseElement
+{
+public:
+    /**
+     * @brief MotionDetectorElement constructor, throws invalid_argument for inconsistent options.
+     * @param config(in): motion detector options.
+     */
+    MotionDetectorElement(const MotionDetectorConfig &config = MotionDetectorConfig{}) :
+            m_config(config), m_motionState(false)
+    {
+        if ((config.m_historySize == 0) || (config.m_blockWidth == 0) || (config.m_blockHeight == 0))
+            throw invalid_argument("MotionDetectorElement history size and block sizes must be strictly positive");
+    }
+
+    /**
+     * @brief MotionDetectorElement destructor.
+     */
+    ~MotionDetectorElement()
+    {
+    }
+
+    /**
+     * @brief to process frame video in order to find changed blocks and motion.
+     * @param videoFrame(in): shared pointer of video frame.
+     * @return void.
+     */
+    void process(shared_ptr<VideoFrame> videoFrame) override
+    {
+        VideoFrame &frame = *videoFrame;
+        if (m_previous && ((m_previous->m_width != frame.m_width) || (m_previous->m_height != frame.m_height) ||
+                           (m_previous->format() != frame.format())))
+        {
+            m_previous.reset();
+            m_changedBlocks.clear();
+        }
+
+        if (!m_previous)
+        {
+            frame.m_changes.m_valid = false;
+        }
+        else
+        {
+            computeChanges(*m_previous, frame);
+            m_changedBlocks.push_back(frame.m_changes.m_dirtyCount);
+            if (m_changedBlocks.size() > m_config.m_historySize)
+                m_changedBlocks.pop_front();
+            reportMotion(frame);
+        }
+
+        m_previous = videoFrame;
+    }
+
+    /**
+     * @brief motion state of last processed frame.
+     * @return bool: true if changed blocks reached threshold for whole history.
+     */
+    bool motionDetected() const
+    {
+        return m_motionState;
+    }
+
+private:
+    /**
+     * @brief compares frame with reference block by block (bytes of block rows, or bits for Mono1
+     * frames, stops at first difference of a block) and stores resulting changed blocks in frame changes.
+     * @param reference(in): previous frame.
+     * @param frame(in/out): current frame.
+     */
+    void computeChanges(const VideoFrame &reference, VideoFrame &frame) const
+    {
+        FrameChanges &changes = frame.m_changes;
+        changes.reset(frame.m_width, frame.m_height, m_config.m_blockWidth, m_config.m_blockHeight, reference.m_sequenceNumber);
+        if (frame.format() == PixelFormat::Mono1)
+        {
+            computeBitsChanges(reference, frame);
+            return;
+        }
+        for (size_t y = 0; y < frame.m_height; y++)
+        {
+            const size_t row = y / m_config.m_blockHeight;
+            const uint8_t *current = frame.row(y).data();
+            const uint8_t *previous = reference.row(y).data();
+            for (size_t column = 0; column < changes.m_blockColumns; column++)
+            {
+                if (changes.isDirty(column, row))
+                    continue;
+                const size_t x = column * m_config.m_blockWidth;
+                if (memcmp(current + x, previous + x, min(m_config.m_blockWidth, size_t(frame.m_width) - x)) != 0)
+                    changes.markDirty(column, row);
+            }
+        }
+    }
+
+    /**
+     * @brief computeChanges of Mono1 frames : words of block range are compared (match mask is ignored).
+     * @param reference(in): previous frame.
+     * @param frame(in/out): current frame, changes already reset.
+     */
+    void computeBitsChanges(const VideoFrame &reference, VideoFrame &frame) const
+    {
+        FrameChanges &changes = frame.m_changes;
+        for (size_t y = 0; y < frame.m_height; y++)
+        {
+            const size_t row = y / m_config.m_blockHeight;
+            const uint64_t *current = frame.bits(y);
+            const uint64_t *previous = reference.bits(y);
+            for (size_t column = 0; column < changes.m_blockColumns; column++)
+            {
+                if (changes.isDirty(column, row))
+                    continue;
+                const size_t first = column * m_config.m_blockWidth;
+                const size_t last = min(first + m_config.m_blockWidth, size_t(frame.m_width));
+                for (size_t word = first / 64; word * 64 < last; word++)
+                {
+                    if ((current[word] ^ previous[word]) & bitRangeMask(word, first, last))
+                    {
+                        changes.markDirty(column, row);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief updates motion state and logs motion start and end.
+     * @param frame(in): current frame.
+     */
+    void reportMotion(const VideoFrame &frame)
+    {
+        const bool motion = (m_changedBlocks.size() == m_config.m_historySize) &&
+                            all_of(m_changedBlocks.begin(), m_changedBlocks.end(), [this](size_t count) {
+                                return count >= m_config.m_minChangedBlocks; });
+        if (motion != m_motionState)
+        {
+            MD_LOG(LogLevel::Info, "***** MOTION " << (motion ? "DETECTED" : "ENDED") << " AT FRAME " << frame.m_sequenceNumber
+                   << " : " << frame.m_changes.m_dirtyCount << " changed blocks ******\n");
+        }
+        m_motionState = motion;
+    }
+
+    MotionDetectorConfig m_config; /**< motion detector options. */
+    shared_ptr<VideoFrame> m_previous; /**< previous frame, reference of changes of next one. */
+    deque<size_t> m_changedBlocks; /**< changed blocks counts of last comparisons, newest last. */
+    bool m_motionState; /**< motion state of last processed frame. */
+};
+
+/**
+ * @brief how consumer of SpscRingBuffer waits for new elements.
+ */
+enum class WaitStrategy : int
+{
+    Spin = 0,         /**< busy polling (lowest latency, one core fully used). */
+    SpinThenPark = 1, /**< polling for a while then sleeping on condition variable. */
+    Futex = 2         /**< polling for a while then sleeping on futex (condition variable on non linux systems). */
+};
+
+/**
+ * @brief cpu hint inside busy polling loops.
+ */
+inline void cpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#else
+    this_thread::yield();
+#endif
+}
+
+/**
+ * @brief bounded lock free single producer single consumer ring buffer.
+ * producer and consumer indexes live on separate cache lines with a cached copy of opposite
+ * index, so that in steady state each side only reads its own cache line. producer wakes
+ * consumer only when consumer announced it is going to sleep, and consumer wakes a producer
+ * waiting for room (waitPush) the same way.
+ * tryPush/waitPush must be called by one producer thread and tryPop/waitPop by one consumer thread.
+ */
+template <typename T>
+class SpscRingBuffer
+{
+public:
+    static constexpr size_t kCacheLineSize = 64; /**< size of padding between producer and consumer data. */
+    static constexpr unsigned kSpinCount = 4096; /**< polling iterations before parking (SpinThenPark, Futex). */
+
+    /**
+     * @brief SpscRingBuffer constructor.
+     * @param capacity(in): max number of elements (> 0).
+     * @param waitStrategy(in): how consumer waits in waitPop.
+     */
+    SpscRingBuffer(size_t capacity, WaitStrategy waitStrategy) :
+            m_capacity(capacity), m_mask(slotsCount(capacity) - 1), m_slots(slotsCount(capacity)), m_waitStrategy(waitStrategy),
+            m_head(0), m_cachedTail(0), m_tail(0), m_cachedHead(0), m_consumerParked(false), m_producerParked(false), m_interrupted(false),
+            m_wakeSequence(0)
+    {
+        if (capacity == 0)
+            throw invalid_argument("SpscRingBuffer capacity must be strictly positive");
+    }
+
+    /**
+     * @brief adds element at end of buffer (producer thread only).
+     * @param value(in): element moved in buffer on success.
+     * @return bool: false if buffer is full (value left unchanged).
+     */
+    bool tryPush(T &value)
+    {
+        const size_t tail = m_tail.load(memory_order_relaxed);
+        if (tail - m_cachedHead >= m_capacity)
+        {
+            m_cachedHead = m_head.load(memory_order_acquire);
+            if (tail - m_cachedHead >= m_capacity)
+                return false;
+        }
+        m_slots[tail & m_mask] = move(value);
+        m_tail.store(tail + 1, memory_order_release);
+        wakeConsumer();
+        return true;
+    }
+
+    /**
+     * @brief adds element at end of buffer waiting for room according to wait strategy up to a
+     * deadline (producer thread only). producer parks on a condition variable (with Futex strategy too).
+     * @param value(in): element moved in buffer on success.
+     * @param deadline(in): end of wait.
+     * @return bool: false if buffer stayed full until deadline or was interrupted (value left unchanged).
+     */
+    template <typename Clock, typename Duration>
+    bool waitPush(T &value, const chrono::time_point<Clock, Duration> &deadline)
+    {
+        for (unsigned spin = 0; ; spin++)
+        {
+            if (tryPush(value))
+                return true;
+            if (m_interrupted.load(memory_order_acquire) || (Clock::now() >= deadline))
+                return false;
+            if ((m_waitStrategy == WaitStrategy::Spin) || (spin < kSpinCount))
+                cpuRelax();
+            else
+                parkProducer(deadline);
+        }
+    }
+
+    /**
+     * @brief removes element at head of buffer (consumer thread only).
+     * @param value(out): removed element.
+     * @return bool: false if buffer is empty.
+     */
+    bool tryPop(T &value)
+    {
+        const size_t head = m_head.load(memory_order_relaxed);
+        if (head == m_cachedTail)
+        {
+            m_cachedTail = m_tail.load(memory_order_acquire);
+            if (head == m_cachedTail)
+                return false;
+        }
+        value = move(m_slots[head & m_mask]);
+        m_slots[head & m_mask] = T{};
+        m_head.store(head + 1, memory_order_release);
+        wakeProducer();
+        return true;
+    }
+
+    /**
+     * @brief removes element at head of buffer waiting for it according to wait strategy
+     * (consumer thread only).
+     * @param value(out): removed element.
+     * @return bool: false if buffer was interrupted while empty.
+     */
+    bool waitPop(T &value)
+    {
+        for (unsigned spin = 0; ; spin++)
+        {
+            if (tryPop(value))
+                return true;
+            if (m_interrupted.load(memory_order_acquire))
+                return false;
+            if ((m_waitStrategy == WaitStrategy::Spin) || (spin < kSpinCount))
+                cpuRelax();
+            else
+                park();
+        }
+    }
+
+    /**
+     * @brief wakes consumer and producer, makes waitPop return false once buffer is empty and
+     * waitPush return false while buffer is full (any thread).
+     */
+    void interrupt()
+    {
+        m_interrupted.store(true, memory_order_seq_cst);
+        {
+            lock_guard<mutex> lock(m_parkLock);
+        }
+        m_parkCv.notify_all();
+        m_spaceCv.notify_all();
+        m_wakeSequence.fetch_add(1, memory_order_seq_cst);
+        futexWake();
+    }
+
+    /**
+     * @brief clears interrupt so that waitPop waits again (consumer not running, see interrupt).
+     */
+    void resume()
+    {
+        m_interrupted.store(false, memory_order_seq_cst);
+    }
+
+    /**
+     * @brief number of elements in buffer (exact only when called by producer or consumer while other side is idle).
+     * @return size_t: elements count.
+     */
+    size_t size() const
+    {
+        return m_tail.load(memory_order_acquire) - m_head.load(memory_order_acquire);
+    }
+
+    size_t capacity() const
+    {
+        return m_capacity;
+    }
+
+private:
+    static size_t slotsCount(size_t capacity)
+    {
+        size_t slots = 1;
+        while (slots < capacity)
+            slots <<= 1;
+        return slots;
+    }
+
+    bool isEmpty() const
+    {
+        return m_head.load(memory_order_relaxed) == m_tail.load(memory_order_seq_cst);
+    }
+
+    bool isFull() const
+    {
+        return m_tail.load(memory_order_relaxed) - m_head.load(memory_order_seq_cst) >= m_capacity;
+    }
+
+    /**
+     * @brief consumer sleeps until producer wakes it (or spurious wake up). consumer announces
+     * it is parked before checking buffer again, producer checks announcement after publishing
+     * new tail : one of them always sees other one.
+     */
+    void park()
+    {
+        if (m_waitStrategy == WaitStrategy::Futex)
+        {
+#if defined(__linux__)
+            const uint32_t sequence = m_wakeSequence.load(memory_order_seq_cst);
+            m_consumerParked.store(true, memory_order_seq_cst);
+            if (isEmpty() && !m_interrupted.load(memory_order_seq_cst))
+                syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_wakeSequence), FUTEX_WAIT_PRIVATE, sequence, nullptr, nullptr, 0);
+            m_consumerParked.store(false, memory_order_relaxed);
+            return;
+#endif
+        }
+        unique_lock<mutex> lock(m_parkLock);
+        m_consumerParked.store(true, memory_order_seq_cst);
+        m_parkCv.wait(lock, [this] { return !isEmpty() || m_interrupted.load(memory_order_seq_cst); });
+        m_consumerParked.store(false, memory_order_relaxed);
+    }
+
+    /**
+     * @brief producer wakes up consumer if it is parked.
+     */
+    void wakeConsumer()
+    {
+        if (m_waitStrategy == WaitStrategy::Spin)
+            return;
+        atomic_thread_fence(memory_order_seq_cst);
+        if (!m_consumerParked.load(memory_order_seq_cst))
+            return;
+        if (m_waitStrategy == WaitStrategy::Futex)
+        {
+#if defined(__linux__)
+            m_wakeSequence.fetch_add(1, memory_order_seq_cst);
+            futexWake();
+            return;
+#endif
+        }
+        {
+            lock_guard<mutex> lock(m_parkLock);
+        }
+        m_parkCv.notify_one();
+    }
+
+    /**
+     * @brief producer sleeps until consumer makes room, buffer is interrupted or deadline is
+     * reached : same handshake as park, with roles of producer and consumer swapped.
+     * @param deadline(in): end of wait.
+     */
+    template <typename Clock, typename Duration>
+    void parkProducer(const chrono::time_point<Clock, Duration> &deadline)
+    {
+        unique_lock<mutex> lock(m_parkLock);
+        m_producerParked.store(true, memory_order_seq_cst);
+        m_spaceCv.wait_until(lock, deadline, [this] { return !isFull() || m_interrupted.load(memory_order_seq_cst); });
+        m_producerParked.store(false, memory_order_relaxed);
+    }
+
+    /**
+     * @brief consumer wakes up producer if it is parked waiting for room.
+     */
+    void wakeProducer()
+    {
+        if (m_waitStrategy == WaitStrategy::Spin)
+            return;
+        atomic_thread_fence(memory_order_seq_cst);
+        if (!m_producerParked.load(memory_order_seq_cst))
+            return;
+        {
+            lock_guard<mutex> lock(m_parkLock);
+        }
+        m_spaceCv.notify_one();
+    }
+
+    void futexWake()
+    {
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_wakeSequence), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#endif
+    }
+
+    const size_t m_capacity; /**< max number of elements. */
+    const size_t m_mask; /**< slots count - 1 (slots count is a power of 2). */
+    vector<T> m_slots; /**< elements storage. */
+    const WaitStrategy m_waitStrategy; /**< consumer wait strategy. */
+
+    alignas(kCacheLineSize) atomic<size_t> m_head; /**< consumer index (next element to pop). */
+    size_t m_cachedTail; /**< consumer copy of producer index. */
+
+    alignas(kCacheLineSize) atomic<size_t> m_tail; /**< producer index (next slot to fill). */
+    size_t m_cachedHead; /**< producer copy of consumer index. */
+
+    alignas(kCacheLineSize) atomic<bool> m_consumerParked; /**< consumer announced it is going to sleep. */
+    atomic<bool> m_producerParked; /**< producer announced it is going to sleep waiting for room. */
+    atomic<bool> m_interrupted; /**< interrupt requested. */
+    atomic<uint32_t> m_wakeSequence; /**< futex word, incremented at each wake up. */
+    mutex m_parkLock; /**< protects condition variable sleeps. */
+    condition_variable m_parkCv; /**< consumer sleep when not using futex. */
+    condition_variable m_spaceCv; /**< producer sleep waiting for room. */
+};
+
+/**
+ * @brief implementation of asynchronous queue.
+ */
+enum class QueueMode : int
+{
+    Locked = 0, /**< mutex protected queue, any number of producers. */
+    Spsc = 1    /**< lock free ring buffer, exactly one producer thread (see SpscRingBuffer). */
+};
+
+/**
+ * @brief what asynchronous queue does with a new frame when it is full.
+ */
+enum class BackpressurePolicy : int
+{
+    DropOldest = 0,    /**< oldest queued frame is dropped to make room (lowest latency). */
+    DropNewest = 1,    /**< new frame is dropped (queued frames are kept). */
+    BlockProducer = 2, /**< producer waits for room up to a timeout, new frame is dropped on timeout (completeness). */
+    KeepEveryNth = 3,  /**< every Nth frame arriving while full replaces oldest one, others are dropped (regular sampling under overload). */
+    Auto = 4           /**< DropOldest in Locked mode, DropNewest in Spsc mode. */
+};
+
+/**
+ * @brief what a stopped queue does with its queued frames.
+ */
+enum class StopMode : int
+{
+    Drain = 0,  /**< queued frames are forwarded before queue stops (last frames of a stream are detected). */
+    Discard = 1 /**< queued frames are released at once (fastest shutdown), counted in QueueStats::m_discarded. */
+};
+
+/**
+ * @brief options of AsynchronousQueue.
+ */
+struct AsynchronousQueueConfig
+{
+    size_t m_maxSize = 1; /**< max number of queued frames (> 0). */
+    QueueMode m_mode = QueueMode::Locked; /**< queue implementation. */
+    WaitStrategy m_waitStrategy = WaitStrategy::SpinThenPark; /**< how consumer thread waits for frames in Spsc mode. */
+    BackpressurePolicy m_policy = BackpressurePolicy::Auto; /**< behavior when queue is full (Spsc mode supports DropNewest and BlockProducer). */
+    chrono::microseconds m_blockTimeout = chrono::milliseconds(100); /**< max producer wait with BlockProducer policy. */
+    size_t m_keepEveryNth = 2; /**< N of KeepEveryNth policy (> 0). */
+    size_t m_maxBatchSize = 1; /**< max number of queued frames forwarded as one batch per wakeup (> 0). */
+    PipelineExecutor *m_executor = nullptr; /**< executor running forwarding tasks of queue, null for a dedicated queue thread. */
+    vector<unsigned> m_cpus; /**< cores of dedicated queue thread, empty for no pinning. */
+};
+
+/**
+ * @brief counters of asynchronous queue.
+ */
+struct QueueStats
+{
+    uint64_t m_accepted; /**< frames queued. */
+    uint64_t m_delivered; /**< frames forwarded to next elements. */
+    uint64_t m_droppedOldest; /**< queued frames dropped to make room (DropOldest, KeepEveryNth). */
+    uint64_t m_droppedNewest; /**< new frames dropped because queue was full (DropNewest, KeepEveryNth). */
+    uint64_t m_droppedOnTimeout; /**< new frames dropped after waiting for room (BlockProducer). */
+    uint64_t m_blockedPushes; /**< pushes which waited for room (BlockProducer). */
+    uint64_t m_discarded; /**< queued frames released by stop (StopMode::Discard). */
+    size_t m_depth; /**< frames currently queued. */
+};
+
+/**
+ * @brief Asynchronous queue element it will be inserted in pipeline in order
+ * to avoid blocking pipeline processing by any heavy processing element(detector for example).
+ * when queue is full, frames are dropped or producer blocked according to backpressure policy
+ * and each drop is counted (see stats). in Spsc mode (one producer only) frames go through a
+ * lock free ring buffer.
+ * with an executor, queue is a scheduling boundary instead of a thread : a push schedules one
+ * forwarding task (if none is scheduled yet) which forwards one batch and reschedules itself while
+ * frames remain queued, so that frames of a queue stay in order and other pipelines get workers
+ * between batches. note that BlockProducer policy then blocks producer worker.
+ */
+class AsynchronousQueue: public BaseElement
+{
+public:
+    /**
+     * @brief AsynchronousQueue constructor (Locked mode, oldest frames dropped when full).
+     * @param queueMaxSize(in): authorized max queue size in terms
+     * of number of frames.
+     * @return void.
+     */
+    AsynchronousQueue(size_t queueMaxSize) :
+            AsynchronousQueue([queueMaxSize] {
+                AsynchronousQueueConfig config;
+                config.m_maxSize = queueMaxSize;
+                return config;
+            }())
+    {
+    }
+
+    /**
+     * @brief AsynchronousQueue constructor, throws invalid_argument for inconsistent options.
+     * @param config(in): queue options.
+     * @return void.
+     */
+    AsynchronousQueue(const AsynchronousQueueConfig &config) :
+            m_runningState(false),
+            m_startedState(false),
+            m_internalThread{},
+            m_config(config),
+            m_overloadedFrames(0),
+            m_accepted(0), m_delivered(0), m_droppedOldest(0), m_droppedNewest(0), m_droppedOnTimeout(0), m_blockedPushes(0),
+            m_discarded(0), m_pendingFrames(0), m_drainScheduled(false)
+    {
+        if (config.m_maxSize == 0)
+            throw invalid_argument("AsynchronousQueue max size must be strictly positive");
+        if (config.m_policy == BackpressurePolicy::Auto)
+            m_config.m_policy = (config.m_mode == QueueMode::Spsc) ? BackpressurePolicy::DropNewest : BackpressurePolicy::DropOldest;
+        if ((config.m_policy == BackpressurePolicy::KeepEveryNth) && (config.m_keepEveryNth == 0))
+            throw invalid_argument("AsynchronousQueue keep every Nth policy needs N > 0");
+        if (config.m_maxBatchSize == 0)
+            throw invalid_argument("AsynchronousQueue max batch size must be strictly positive");
+        m_batch.reserve(config.m_maxBatchSize);
+        if (config.m_mode == QueueMode::Spsc)
+        {
+            if ((m_config.m_policy != BackpressurePolicy::DropNewest) && (m_config.m_policy != BackpressurePolicy::BlockProducer))
+                throw invalid_argument("AsynchronousQueue Spsc mode supports DropNewest and BlockProducer policies only");
+            m_ringBuffer = make_unique<SpscRingBuffer<shared_ptr<VideoFrame>>>(config.m_maxSize, config.m_waitStrategy);
+        }
+    }
+
+    /**
+     * @brief AsynchronousQueue destructor : stops queue discarding queued frames (see stop).
+     */
+    ~AsynchronousQueue()
+    {
+        stop(StopMode::Discard);
+    }
+
+    /**
+     * @brief stops queue thread (or forwarding tasks) once upstream elements are stopped : it
+     * interrupts thread by setting running state to false, unblocks it if it waits for frames and
+     * joins it. next pushed frame starts queue again (hot restart).
+     * @param mode(in): Drain waits until queued frames are forwarded, Discard releases them.
+     */
+    void stop(StopMode mode = StopMode::Drain)
+    {
+        lock_guard<mutex> lifecycle(m_lifecycleLock);
+        if (!m_startedState)
+            return;
+        if (mode == StopMode::Drain)
+        {
+            unique_lock<mutex> lock(m_queueLock);
+            m_drainCv.wait(lock, [this] { return m_pendingFrames == 0; });
+        }
+        {
+            lock_guard<mutex> lock(m_queueLock);
+            m_runningState = false;
+        }
         m_queueCv.notify_all();
+        m_spaceCv.notify_all();
+        if (m_ringBuffer)
+            m_ringBuffer->interrupt();
         if (m_internalThread.joinable())
             m_internalThread.join();
-        checkQueueSizeConstraint(0);
+
+        queue<shared_ptr<VideoFrame>> discarded;
+        {
+            // waits end of forwarding task scheduled on executor
+            unique_lock<mutex> lock(m_queueLock);
+            m_drainCv.wait(lock, [this] { return !m_drainScheduled; });
+            discarded.swap(m_videoFramesQueue);
+        }
+        size_t count = discarded.size();
+        if (m_ringBuffer)
+        {
+            // queue thread has ended, stopping thread is consumer of ring buffer
+            for (shared_ptr<VideoFrame> videoFrame; m_ringBuffer->tryPop(videoFrame); count++)
+                videoFrame.reset();
+            m_ringBuffer->resume();
+        }
+        discardFrames(count);
+        m_startedState = false;
+    }
+
+    /**
+     * @brief process frame : it will start thread for queue management
+     * if not started and then add new frame in queue.
+     * @param videoFrame(in): shared pointer of video frame.
+     * @return void.
+     */
+    void process(shared_ptr<VideoFrame> videoFrame) override
+    {
+        start();
+        pushNewVideoFrame(videoFrame);
+    }
+
+    /**
+     * @brief overloaded nothing to do as pushdown stream will be
+     * managed asynchronously by reading from queue in separate
+     * thread.
+     * @param videoFrame(in): shared pointer of video frame.
+     * @return void.
+     */
+    void processAndPushDownstream(shared_ptr<VideoFrame> videoFrame) override
+    {
+        (void)videoFrame;
+        return;
+    }
+
+    /**
+     * @brief to push a batch of frames in queue (each frame goes through backpressure policy).
+     * @param videoFrames(in): frames of batch.
+     * @return void.
+     */
+    void processBatch(FrameSpan videoFrames) override
+    {
+        start();
+        for (const auto &videoFrame : videoFrames)
+            pushNewVideoFrame(videoFrame);
+    }
+
+    /**
+     * @brief overloaded nothing to do as for processAndPushDownstream.
+     * @param videoFrames(in): frames of batch.
+     * @return void.
+     */
+    void processBatchAndPushDownstream(FrameSpan videoFrames) override
+    {
+        (void)videoFrames;
+        return;
+    }
+
+    /**
+     * @brief snapshot of queue counters.
+     * @return QueueStats.
+     */
+    QueueStats stats() const
+    {
+        return QueueStats{m_accepted.load(memory_order_relaxed), m_delivered.load(memory_order_relaxed),
+                          m_droppedOldest.load(memory_order_relaxed), m_droppedNewest.load(memory_order_relaxed),
+                          m_droppedOnTimeout.load(memory_order_relaxed), m_blockedPushes.load(memory_order_relaxed),
+                          m_discarded.load(memory_order_relaxed), queueDepth()};
+    }
+
+    /**
+     * @brief statistics of element completed with queue depth and dropped frames.
+     * @param resetPeaks(in): max values are reset.
+     * @return ElementStats: statistics.
+     */
+    ElementStats elementStats(bool resetPeaks) override
+    {
+        ElementStats elementStats = BaseElement::elementStats(resetPeaks);
+        const QueueStats queueStats = stats();
+        elementStats.m_queue = true;
+        elementStats.m_queueDepth = queueStats.m_depth;
+        elementStats.m_dropped = queueStats.m_droppedOldest + queueStats.m_droppedNewest + queueStats.m_droppedOnTimeout +
+                                 queueStats.m_discarded;
+        return elementStats;
+    }
+
+    /**
+     * @brief number of frames currently queued.
+     * @return size_t: queue depth.
+     */
+    size_t queueDepth() const
+    {
+        if (m_ringBuffer)
+            return m_ringBuffer->size();
+        lock_guard<mutex> lock(m_queueLock);
+        return m_videoFramesQueue.size();
+    }
+private:
+    atomic<bool> m_runningState;/**< running state of thread, changed under queue lock. */
+    atomic<bool> m_startedState;/**< start state of thread : it differs from running state as we can interrupt
+    started thread for example : to avoid start interrupted thread. changed under lifecycle lock. */
+    mutex m_lifecycleLock;/**< serializes start and stop. */
+    thread m_internalThread;/**< pattern to detect. */
+    queue<shared_ptr<VideoFrame>> m_videoFramesQueue;/**< queue of video frame shared pointers. */
+    mutable mutex m_queueLock;/**< mutex to protect wakeup condition. */
+    condition_variable m_queueCv;/**< conditional variable to wakeup read from queue. */
+    condition_variable m_spaceCv;/**< conditional variable to wakeup producer blocked on full queue. */
+    AsynchronousQueueConfig m_config;/**< queue options (max size, mode, policy). */
+    unique_ptr<SpscRingBuffer<shared_ptr<VideoFrame>>> m_ringBuffer;/**< lock free ring buffer in Spsc mode, null in Locked mode. */
+    uint64_t m_overloadedFrames;/**< frames arrived while queue was full (KeepEveryNth policy). */
+    atomic<uint64_t> m_accepted;/**< see QueueStats. */
+    atomic<uint64_t> m_delivered;/**< see QueueStats. */
+    atomic<uint64_t> m_droppedOldest;/**< see QueueStats. */
+    atomic<uint64_t> m_droppedNewest;/**< see QueueStats. */
+    atomic<uint64_t> m_droppedOnTimeout;/**< see QueueStats. */
+    atomic<uint64_t> m_blockedPushes;/**< see QueueStats. */
+    atomic<uint64_t> m_discarded;/**< see QueueStats. */
+    atomic<size_t> m_pendingFrames;/**< frames accepted and not yet forwarded nor dropped, see stop. */
+    vector<shared_ptr<VideoFrame>> m_batch;/**< frames forwarded by queue thread in current wakeup. */
+    atomic<bool> m_drainScheduled;/**< true while a forwarding task is scheduled on executor. */
+    condition_variable m_drainCv;/**< notified when no more forwarding task is scheduled. */
+
+    /**
+     * @brief starts asynchronous queue thread if not started.
+     * @param videoFrame(in): shared pointer of video frame.
+     */
+    void start()
+    {
+        if (m_startedState.load(memory_order_acquire))
+            return;
+        lock_guard<mutex> lifecycle(m_lifecycleLock);
+        if (m_startedState)
+            return;
+        {
+            lock_guard<mutex> lock(m_queueLock);
+            m_runningState = true;
+        }
+        if (!m_config.m_executor)
+        {
+            if (m_ringBuffer)
+                m_internalThread = thread{&AsynchronousQueue::popNewVideoFrames, this };
+            else
+                m_internalThread = thread{&AsynchronousQueue::waitForNewVideoFrame, this };
+            CpuAffinity::pin(m_internalThread.native_handle(), m_config.m_cpus);
+        }
+        m_startedState.store(true, memory_order_release);
+    }
+
+    /**
+     * @brief deletes oldest frame of queue (queue lock must be held).
+     */
+    void dropOldestVideoFrame()
+    {
+        m_videoFramesQueue.pop(); //remove element from queue and free memory hold by shared pointer
+        m_droppedOldest.fetch_add(1, memory_order_relaxed);
+        m_pendingFrames--;
+    }
+
+    /**
+     * @brief frames accepted by queue are not pending anymore (forwarded, dropped or discarded),
+     * wakes stop waiting for drain (queue lock must not be held).
+     * @param count(in): number of frames.
+     */
+    void releasePendingFrames(size_t count)
+    {
+        if (count && (m_pendingFrames.fetch_sub(count) == count))
+        {
+            lock_guard<mutex> lock(m_queueLock);
+            m_drainCv.notify_all();
+        }
+    }
+
+    /**
+     * @brief counts frames released without being forwarded (queue lock must not be held).
+     * @param count(in): number of frames.
+     */
+    void discardFrames(size_t count)
+    {
+        m_discarded.fetch_add(count, memory_order_relaxed);
+        releasePendingFrames(count);
+    }
+
+    /**
+     * @brief adds new frame in queue (at the end of queue).
+     * it starts by checking queue size and applies backpressure policy
+     * when queue is full, then push new frame and then wakeup queue read
+     * to forward new frame for next elements to process.
+     * @param newVideoFrame(in): shared pointer of video frame.
+     */
+    void pushNewVideoFrame(shared_ptr<VideoFrame> newVideoFrame)
+    {
+        if (m_ringBuffer)
+        {
+            pushNewVideoFrameToRingBuffer(newVideoFrame);
+            return;
+        }
+
+        unique_lock<mutex> lock(m_queueLock);
+        if (m_videoFramesQueue.size() >= m_config.m_maxSize)
+        {
+            switch (m_config.m_policy)
+            {
+            case BackpressurePolicy::Auto: // resolved to DropOldest by constructor in Locked mode
+            case BackpressurePolicy::DropOldest:
+                dropOldestVideoFrame();
+                break;
+            case BackpressurePolicy::DropNewest:
+                m_droppedNewest.fetch_add(1, memory_order_relaxed);
+                return;
+            case BackpressurePolicy::KeepEveryNth:
+                if ((++m_overloadedFrames % m_config.m_keepEveryNth) != 0)
+                {
+                    m_droppedNewest.fetch_add(1, memory_order_relaxed);
+                    return;
+                }
+                dropOldestVideoFrame();
+                break;
+            case BackpressurePolicy::BlockProducer:
+                m_blockedPushes.fetch_add(1, memory_order_relaxed);
+                if (!m_spaceCv.wait_for(lock, m_config.m_blockTimeout, [this] {
+                        return (m_videoFramesQueue.size() < m_config.m_maxSize) || !m_runningState; }) || !m_runningState)
+                {
+                    m_droppedOnTimeout.fetch_add(1, memory_order_relaxed);
+                    return;
+                }
+                break;
+            }
+        }
+        m_videoFramesQueue.push(newVideoFrame);
+        m_accepted.fetch_add(1, memory_order_relaxed);
+        m_pendingFrames++;
+        lock.unlock();
+        m_queueCv.notify_one();
+        scheduleDrain();
+    }
+
+    /**
+     * @brief schedules forwarding task on executor if queue has one and no task is scheduled yet.
+     */
+    void scheduleDrain()
+    {
+        if (m_config.m_executor && !m_drainScheduled.exchange(true))
+            m_config.m_executor->submit([this] { drainOnExecutor(); });
+    }
+
+    /**
+     * @brief forwarding task executed on executor : forwards one batch of queued frames to next
+     * elements, then reschedules itself if frames remain or marks that no task is scheduled.
+     */
+    void drainOnExecutor()
+    {
+        if (m_runningState)
+        {
+            if (m_ringBuffer)
+            {
+                shared_ptr<VideoFrame> newVideoFrame;
+                while ((m_batch.size() < m_config.m_maxBatchSize) && m_ringBuffer->tryPop(newVideoFrame))
+                    m_batch.push_back(move(newVideoFrame));
+            }
+            else
+            {
+                {
+                    lock_guard<mutex> lock(m_queueLock);
+                    while (m_videoFramesQueue.size() && (m_batch.size() < m_config.m_maxBatchSize))
+                    {
+                        m_batch.push_back(move(m_videoFramesQueue.front()));
+                        m_videoFramesQueue.pop();
+                    }
+                }
+                if (m_config.m_policy == BackpressurePolicy::BlockProducer)
+                    m_spaceCv.notify_all();
+            }
+            if (!m_batch.empty())
+                forwardBatch();
+        }
+
+        // queue lock is held until end of task as destructor waits on it for last task
+        lock_guard<mutex> lock(m_queueLock);
+        m_drainScheduled = false;
+        const bool framesQueued = m_ringBuffer ? (m_ringBuffer->size() > 0) : !m_videoFramesQueue.empty();
+        if (m_runningState && framesQueued && !m_drainScheduled.exchange(true))
+        {
+            m_config.m_executor->yield([this] { drainOnExecutor(); });
+            return;
+        }
+        m_drainCv.notify_all();
+    }
+
+    /**
+     * @brief adds new frame in ring buffer (Spsc mode) : new frame is dropped when ring buffer
+     * is full, after waiting for room up to timeout with BlockProducer policy (see SpscRingBuffer::waitPush).
+     * @param newVideoFrame(in): shared pointer of video frame.
+     */
+    void pushNewVideoFrameToRingBuffer(shared_ptr<VideoFrame> &newVideoFrame)
+    {
+        // counted before push as consumer may forward frame at once
+        m_pendingFrames++;
+        if (m_ringBuffer->tryPush(newVideoFrame))
+        {
+            m_accepted.fetch_add(1, memory_order_relaxed);
+            scheduleDrain();
+            return;
+        }
+        if (m_config.m_policy != BackpressurePolicy::BlockProducer)
+        {
+            m_droppedNewest.fetch_add(1, memory_order_relaxed);
+            releasePendingFrames(1);
+            return;
+        }
+
+        m_blockedPushes.fetch_add(1, memory_order_relaxed);
+        if (m_runningState && m_ringBuffer->waitPush(newVideoFrame, FrameClock::now() + m_config.m_blockTimeout))
+        {
+            m_accepted.fetch_add(1, memory_order_relaxed);
+            scheduleDrain();
+            return;
+        }
+        m_droppedOnTimeout.fetch_add(1, memory_order_relaxed);
+        releasePendingFrames(1);
+    }
+
+    /**
+     * @brief method executed in thread of asynchronous queue.
+     * it reads from the head of queue and forward for processing
+     * to next element and then sleep waiting for new frames.
+     */
+    void waitForNewVideoFrame(void)
+    {
+        unique_lock<mutex> lock(m_queueLock);
+
+        for (;;)
+        {
+            //Wait until new frame video added notified or stop (running state changes under queue lock).
+            m_queueCv.wait(lock, [this]
+            {
+                return !m_videoFramesQueue.empty() || !m_runningState;
+            });
+            if (!m_runningState)
+                return;
+
+            //after wait, we own the lock, get up to max batch size oldest elements from queue
+            while (m_videoFramesQueue.size() && (m_batch.size() < m_config.m_maxBatchSize))
+            {
+                m_batch.push_back(move(m_videoFramesQueue.front()));
+                m_videoFramesQueue.pop();//remove element from queue
+            }
+
+            //unlock now as we already got video frames from queue to process
+            lock.unlock();
+            if (m_config.m_policy == BackpressurePolicy::BlockProducer)
+                m_spaceCv.notify_all();
+            forwardBatch();
+            lock.lock();
+        }
+    }
+
+    /**
+     * @brief forwards frames of current batch to next elements (one frame per call when max batch
+     * size is 1) and releases them.
+     */
+    void forwardBatch(void)
+    {
+        // to notify next elements
+        const FrameSpan batch(m_batch);
+        if (!m_nextElements.empty() && ElementCounters::isEnabled())
+            m_counters.recordOutput(batch.size());
+        if (batch.size() == 1)
+        {
+            for_each(m_nextElements.cbegin(), m_nextElements.cend(), [&batch](const auto &element)
+            {
+                dispatchFrame(element, batch[0]);
+            });
+        }
+        else
+        {
+            for_each(m_nextElements.cbegin(), m_nextElements.cend(), [&batch](const auto &element)
+            {
+                dispatchBatch(element, batch);
+            });
+        }
+        m_delivered.fetch_add(batch.size(), memory_order_relaxed);
+        m_batch.clear();
+        releasePendingFrames(batch.size());
+    }
+
+    /**
+     * @brief method executed in thread of asynchronous queue in Spsc mode.
+     * it pops frames from ring buffer (waiting according to wait strategy)
+     * and forwards them for processing to next elements until interrupted.
+     */
+    void popNewVideoFrames(void)
+    {
+        shared_ptr<VideoFrame> newVideoFrame;
+        while (m_ringBuffer->waitPop(newVideoFrame))
+        {
+            if (!m_runningState)
+            {
+                newVideoFrame.reset();
+                discardFrames(1);
+                break;
+            }
+            m_batch.push_back(move(newVideoFrame));
+            while ((m_batch.size() < m_config.m_maxBatchSize) && m_ringBuffer->tryPop(newVideoFrame))
+                m_batch.push_back(move(newVideoFrame));
+            forwardBatch();
+        }
+    }
+};
+
+class StreamQueue;
+
+/**
+ * @brief shard of a StreamScheduler : streams served by one worker thread, so that frames of a
+ * stream and state of its elements stay in caches of that worker.
+ */
+struct StreamShard
+{
+    mutex m_lock; /**< protects ready list, service state and queued frames of streams of shard. */
+    condition_variable m_readyCv; /**< notified when a stream becomes ready or scheduler stops. */
+    condition_variable m_serviceCv; /**< notified when worker ends service of a stream. */
+    deque<StreamQueue*> m_ready; /**< streams with queued frames waiting for their turn, in round robin order. */
+    StreamQueue *m_inService = nullptr; /**< stream whose frames worker is forwarding. */
+    size_t m_streams = 0; /**< streams attached to shard. */
+    bool m_running = true; /**< false once worker must exit. */
+    thread m_worker; /**< worker thread of shard. */
+};
+
+/**
+ * @brief worker threads shared by many streams (multi camera host) : each stream queue (StreamQueue)
+ * is attached to one shard (least loaded one) and always forwarded by worker of that shard (stream
+ * affinity). a worker serves ready streams of its shard in round robin, at most quantum frames per
+ * turn, so that a stream with a high frame rate or slow elements cannot starve other streams.
+ */
+class StreamScheduler
+{
+public:
+    /**
+     * @brief StreamScheduler constructor : starts workers.
+     * @param workers(in): number of workers (shards), 0 : one per core.
+     * @param quantum(in): frames of a stream forwarded per turn (> 0).
+     * @param cpus(in): cores of workers (worker i on cpus[i % size]), empty for no pinning.
+     */
+    StreamScheduler(size_t workers = 0, size_t quantum = 1, const vector<unsigned> &cpus = {}) : m_quantum(quantum), m_cpus(cpus)
+    {
+        if (quantum == 0)
+            throw invalid_argument("StreamScheduler quantum must be strictly positive");
+        const size_t count = workers ? workers : (cpus.empty() ? max(1u, thread::hardware_concurrency()) : cpus.size());
+        for (size_t i = 0; i < count; i++)
+            m_shards.push_back(make_unique<StreamShard>());
+        for (size_t i = 0; i < count; i++)
+        {
+            m_shards[i]->m_worker = thread(&StreamScheduler::workerLoop, this, m_shards[i].get());
+            CpuAffinity::pinOne(m_shards[i]->m_worker.native_handle(), cpus, i);
+        }
+    }
+    /**
+     * @brief StreamScheduler destructor : stops workers, stream queues must be destroyed before.
+     */
+    ~StreamScheduler()
+    {
+        for (auto &shard : m_shards)
+        {
+            {
+                lock_guard<mutex> lock(shard->m_lock);
+                shard->m_running = false;
+            }
+            shard->m_readyCv.notify_one();
+            shard->m_worker.join();
+        }
+    }
+    StreamScheduler(const StreamScheduler &) = delete;
+    StreamScheduler& operator=(const StreamScheduler &) = delete;
+
+    /**
+     * @brief number of workers.
+     * @return size_t: workers count.
+     */
+    size_t size() const
+    {
+        return m_shards.size();
+    }
+
+    /**
+     * @brief attaches a stream to least loaded shard.
+     * @return size_t: index of shard.
+     */
+    size_t attach()
+    {
+        lock_guard<mutex> lock(m_attachLock);
+        size_t index = 0;
+        for (size_t i = 1; i < m_shards.size(); i++)
+            if (m_shards[i]->m_streams < m_shards[index]->m_streams)
+                index = i;
+        lock_guard<mutex> shardLock(m_shards[index]->m_lock);
+        m_shards[index]->m_streams++;
+        return index;
+    }
+
+    /**
+     * @brief shard of an attached stream.
+     * @param index(in): index given by attach.
+     * @return StreamShard.
+     */
+    StreamShard& shard(size_t index)
+    {
+        return *m_shards[index];
+    }
+
+    /**
+     * @brief NUMA node of core of worker of a shard, for frames of its streams.
+     * @param index(in): index of shard.
+     * @return int: node, -1 for unpinned workers or unknown node.
+     */
+    int numaNode(size_t index) const
+    {
+        return m_cpus.empty() ? -1 : CpuAffinity::nodeOfCpu(m_cpus[index % m_cpus.size()]);
+    }
+
+private:
+    /**
+     * @brief method executed by worker of a shard (defined after StreamQueue).
+     * @param shard(in): shard of worker.
+     */
+    void workerLoop(StreamShard *shard);
+
+    size_t m_quantum; /**< see constructor. */
+    vector<unsigned> m_cpus; /**< see constructor. */
+    mutex m_attachLock; /**< serializes attachments. */
+    vector<unique_ptr<StreamShard>> m_shards; /**< shards and their workers. */
+};
+
+/**
+ * @brief bounded queue of one stream forwarded by a worker of a StreamScheduler (oldest frame is
+ * dropped when queue is full, so that a late stream keeps latest frames). frames of a stream are
+ * forwarded in order by one worker at a time.
+ */
+class StreamQueue: public BaseElement
+{
+public:
+    static constexpr size_t kDefaultMaxSize = 2; /**< default max number of queued frames. */
+
+    /**
+     * @brief StreamQueue constructor : attaches stream to a shard of scheduler.
+     * @param scheduler(in): scheduler outliving queue.
+     * @param maxSize(in): max number of queued frames (> 0).
+     */
+    StreamQueue(StreamScheduler &scheduler, size_t maxSize = kDefaultMaxSize) :
+            m_maxSize(maxSize), m_shardIndex(0), m_shard(nullptr), m_scheduled(false), m_accepted(0), m_delivered(0), m_dropped(0),
+            m_discarded(0)
+    {
+        if (maxSize == 0)
+            throw invalid_argument("StreamQueue size must be strictly positive");
+        m_shardIndex = scheduler.attach();
+        m_shard = &scheduler.shard(m_shardIndex);
+    }
+    /**
+     * @brief StreamQueue destructor : detaches stream once its worker does not forward it anymore,
+     * queued frames are released.
+     */
+    ~StreamQueue()
+    {
+        unique_lock<mutex> lock(m_shard->m_lock);
+        m_shard->m_ready.erase(remove(m_shard->m_ready.begin(), m_shard->m_ready.end(), this), m_shard->m_ready.end());
+        m_shard->m_serviceCv.wait(lock, [this] { return m_shard->m_inService != this; });
+        m_shard->m_streams--;
+        m_frames.clear();
+    }
+
+    /**
+     * @brief stops stream once its source is stopped : queued frames are forwarded by worker of
+     * shard (Drain) or released (Discard), next queued frame makes stream ready again.
+     * @param mode(in): what is done with queued frames.
+     */
+    void stop(StopMode mode = StopMode::Drain)
+    {
+        deque<shared_ptr<VideoFrame>> discarded;
+        {
+            unique_lock<mutex> lock(m_shard->m_lock);
+            if (mode == StopMode::Discard)
+            {
+                discarded.swap(m_frames);
+                m_discarded.fetch_add(discarded.size(), memory_order_relaxed);
+            }
+            // stream leaves ready list once empty after its last turn
+            m_shard->m_serviceCv.wait(lock, [this] { return !m_scheduled || (m_frames.empty() && (m_shard->m_inService != this)); });
+            if (m_scheduled)
+            {
+                m_shard->m_ready.erase(remove(m_shard->m_ready.begin(), m_shard->m_ready.end(), this), m_shard->m_ready.end());
+                m_scheduled = false;
+            }
+        }
+    }
+
+    /**
+     * @brief queues frame and makes stream ready for its worker.
+     * @param videoFrame(in): shared pointer of video frame.
+     */
+    void process(shared_ptr<VideoFrame> videoFrame) override
+    {
+        processBatch(FrameSpan(&videoFrame, 1));
+    }
+
+    /**
+     * @brief overloaded nothing to do : frames are forwarded by worker of shard.
+     * @param videoFrame(in): shared pointer of video frame.
+     */
+    void processAndPushDownstream(shared_ptr<VideoFrame> videoFrame) override
+    {
+        (void)videoFrame;
+    }
+
+    /**
+     * @brief queues frames of a batch.
+     * @param videoFrames(in): frames of batch.
+     */
+    void processBatch(FrameSpan videoFrames) override
+    {
+        shared_ptr<VideoFrame> dropped;
+        bool notify = false;
+        {
+            lock_guard<mutex> lock(m_shard->m_lock);
+            for (const auto &videoFrame : videoFrames)
+            {
+                if (m_frames.size() == m_maxSize)
+                {
+                    // released out of lock
+                    dropped = move(m_frames.front());
+                    m_frames.pop_front();
+                    m_dropped.fetch_add(1, memory_order_relaxed);
+                }
+                m_frames.push_back(videoFrame);
+            }
+            m_accepted.fetch_add(videoFrames.size(), memory_order_relaxed);
+            if (!m_scheduled && !m_frames.empty())
+            {
+                m_scheduled = true;
+                m_shard->m_ready.push_back(this);
+                notify = true;
+            }
+        }
+        if (notify)
+            m_shard->m_readyCv.notify_one();
+    }
+
+    /**
+     * @brief overloaded nothing to do as for processAndPushDownstream.
+     * @param videoFrames(in): frames of batch.
+     */
+    void processBatchAndPushDownstream(FrameSpan videoFrames) override
+    {
+        (void)videoFrames;
+    }
+
+    /**
+     * @brief snapshot of queue counters (DropOldest counters of QueueStats).
+     * @return QueueStats.
+     */
+    QueueStats stats() const
+    {
+        size_t depth = 0;
+        {
+            lock_guard<mutex> lock(m_shard->m_lock);
+            depth = m_frames.size();
+        }
+        return QueueStats{m_accepted.load(memory_order_relaxed), m_delivered.load(memory_order_relaxed),
+                          m_dropped.load(memory_order_relaxed), 0, 0, 0, m_discarded.load(memory_order_relaxed), depth};
+    }
+
+    /**
+     * @brief statistics of element completed with queue depth and dropped frames.
+     * @param resetPeaks(in): max values are reset.
+     * @return ElementStats: statistics.
+     */
+    ElementStats elementStats(bool resetPeaks) override
+    {
+        ElementStats elementStats = BaseElement::elementStats(resetPeaks);
+        const QueueStats queueStats = stats();
+        elementStats.m_queue = true;
+        elementStats.m_queueDepth = queueStats.m_depth;
+        elementStats.m_dropped = queueStats.m_droppedOldest + queueStats.m_discarded;
+        return elementStats;
+    }
+
+    /**
+     * @brief index of shard (worker) forwarding stream.
+     * @return size_t: shard index.
+     */
+    size_t shardIndex() const
+    {
+        return m_shardIndex;
+    }
+
+private:
+    friend class StreamScheduler;
+
+    /**
+     * @brief forwards frames taken by worker to next elements (called out of shard lock).
+     * @param batch(in): frames of stream, in order.
+     */
+    void forward(const vector<shared_ptr<VideoFrame>> &batch)
+    {
+        if (batch.size() == 1)
+            BaseElement::processAndPushDownstream(batch[0]);
+        else
+            BaseElement::processBatchAndPushDownstream(FrameSpan(batch));
+        m_delivered.fetch_add(batch.size(), memory_order_relaxed);
+    }
+
+    size_t m_maxSize; /**< see constructor. */
+    size_t m_shardIndex; /**< see shardIndex. */
+    StreamShard *m_shard; /**< shard of stream. */
+    deque<shared_ptr<VideoFrame>> m_frames; /**< queued frames, protected by shard lock. */
+    bool m_scheduled; /**< true while stream is in ready list or in service, protected by shard lock. */
+    atomic<uint64_t> m_accepted; /**< frames queued. */
+    atomic<uint64_t> m_delivered; /**< frames forwarded. */
+    atomic<uint64_t> m_dropped; /**< frames dropped to make room. */
+    atomic<uint64_t> m_discarded; /**< frames released by stop. */
+};
+
+inline void StreamScheduler::workerLoop(StreamShard *shard)
+{
+    vector<shared_ptr<VideoFrame>> batch;
+    unique_lock<mutex> lock(shard->m_lock);
+    for (;;)
+    {
+        shard->m_readyCv.wait(lock, [shard] { return !shard->m_ready.empty() || !shard->m_running; });
+        if (!shard->m_running)
+            return;
+        StreamQueue *queue = shard->m_ready.front();
+        shard->m_ready.pop_front();
+        while ((batch.size() < m_quantum) && !queue->m_frames.empty())
+        {
+            batch.push_back(move(queue->m_frames.front()));
+            queue->m_frames.pop_front();
+        }
+        shard->m_inService = queue;
+        lock.unlock();
+        try
+        {
+            queue->forward(batch);
+        } catch (const exception &e)
+        {
+            MD_LOG(LogLevel::Info, "StreamScheduler stream failed : " << e.what() << "\n");
+        }
+        batch.clear();
+        lock.lock();
+        shard->m_inService = nullptr;
+        // stream with frames left waits for its next turn behind other ready streams
+        if (queue->m_frames.empty())
+            queue->m_scheduled = false;
+        else
+            shard->m_ready.push_back(queue);
+        shard->m_serviceCv.notify_all();
+    }
+}
+
+/**
+ * @brief fixed size binary record of one detection (native byte order), written by DetectionEventSink.
+ */
+struct DetectionRecord
+{
+    uint64_t m_sequenceNumber; /**< sequence number of frame. */
+    int64_t m_captureTimestamp; /**< capture time of frame in nanoseconds of steady clock (see DetectionEventsHeader). */
+    uint32_t m_x; /**< column of first pixel of match. */
+    uint32_t m_y; /**< row of first pixel of match. */
+    uint32_t m_patternId; /**< index of pattern in detector patterns. */
+    uint16_t m_width; /**< columns of pattern. */
+    uint16_t m_height; /**< rows of pattern. */
+};
+static_assert(sizeof(DetectionRecord) == 32, "detection records are 32 bytes");
+
+/**
+ * @brief header of a detection events file, same size as a record so that records stay aligned.
+ */
+struct DetectionEventsHeader
+{
+    char m_magic[8]; /**< "MDEVENTS". */
+    uint32_t m_version; /**< layout version of records (1). */
+    uint32_t m_recordSize; /**< sizeof(DetectionRecord). */
+    int64_t m_systemClockOffset; /**< nanoseconds to add to capture timestamps to get system clock (UTC) time. */
+    uint64_t m_reserved; /**< 0. */
+};
+static_assert(sizeof(DetectionEventsHeader) == sizeof(DetectionRecord), "detection events header is one record");
+
+/**
+ * @brief counters of detection events sink.
+ */
+struct DetectionSinkStats
+{
+    uint64_t m_events; /**< records queued. */
+    uint64_t m_written; /**< records written to output. */
+    uint64_t m_flushes; /**< writes of buffers to output. */
+    uint64_t m_blockedFrames; /**< frames which waited for writer because buffers were full. */
+    uint64_t m_writeErrors; /**< failed writes (records of failed writes are lost). */
+    uint64_t m_lostRecords; /**< records not written : records of failed writes, then all records once reader of pipe is gone. */
+};
+
+/**
+ * @brief sink writing detections of frames (DetectionOverlay boxes, so detectors must use Overlay
+ * marking) as fixed size DetectionRecord after a DetectionEventsHeader, to a file or a pipe, so that
+ * consumers ingest events without parsing text logs. element forwards frames unchanged, it can be
+ * inserted anywhere after a detector.
+ * records are appended to a buffer under a lock once per frame (or batch) and a writer thread
+ * writes full buffers (or any pending record every flush interval) while next buffer fills :
+ * pipeline waits only when writer is one full buffer behind (events are never dropped while output
+ * is writable). when output is a pipe, SIGPIPE is ignored so that a reader exiting does not kill
+ * process : sink logs it once and then drops records (counted as lost).
+ */
+class DetectionEventSink: public BaseElement
+{
+public:
+    static constexpr size_t kDefaultBufferRecords = 1 << 16; /**< default records of a buffer (2 MiB). */
+    static constexpr chrono::milliseconds kDefaultFlushInterval{100}; /**< default max delay of a record. */
+
+    /**
+     * @brief DetectionEventSink constructor : creates (or truncates) output and writes its header,
+     * throws invalid_argument when output cannot be opened.
+     * @param path(in): output file or pipe.
+     * @param bufferRecords(in): records of a buffer (> 0).
+     * @param flushInterval(in): max delay between queuing and writing of a record.
+     */
+    DetectionEventSink(const string &path, size_t bufferRecords = kDefaultBufferRecords,
+                       FrameClock::duration flushInterval = kDefaultFlushInterval) :
+            m_bufferRecords(bufferRecords), m_flushInterval(flushInterval), m_fd(-1), m_running(true), m_flushRequested(false),
+            m_readerGone(false), m_boxes{}, m_stats{}
+    {
+        if (bufferRecords == 0)
+            throw invalid_argument("DetectionEventSink buffer must hold at least one record");
+        m_fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (m_fd < 0)
+            throw invalid_argument("cannot open detection events output " + path + " : " + strerror(errno));
+        struct stat status;
+        if ((fstat(m_fd, &status) == 0) && !S_ISREG(status.st_mode))
+        {
+            // write to a pipe without reader fails with EPIPE instead of killing process
+            signal(SIGPIPE, SIG_IGN);
+        }
+        DetectionEventsHeader header{};
+        memcpy(header.m_magic, "MDEVENTS", sizeof(header.m_magic));
+        header.m_version = 1;
+        header.m_recordSize = sizeof(DetectionRecord);
+        header.m_systemClockOffset = chrono::duration_cast<chrono::nanoseconds>(chrono::system_clock::now().time_since_epoch()).count() -
+                                     chrono::duration_cast<chrono::nanoseconds>(FrameClock::now().time_since_epoch()).count();
+        if (!writeAll(&header, sizeof(header)))
+        {
+            const int error = errno;
+            close(m_fd);
+            throw invalid_argument("cannot write detection events output " + path + " : " + strerror(error));
+        }
+        m_pending.reserve(bufferRecords);
+        m_writing.reserve(bufferRecords);
+        m_writer = thread(&DetectionEventSink::writeRecords, this);
+    }
+    /**
+     * @brief DetectionEventSink destructor : writes pending records and closes output.
+     */
+    ~DetectionEventSink()
+    {
+        {
+            lock_guard<mutex> lock(m_lock);
+            m_running = false;
+        }
+        m_writerCv.notify_one();
+        m_writer.join();
+        close(m_fd);
+    }
+
+    /**
+     * @brief queues records of detections of frame.
+     * @param videoFrame(in): shared pointer of video frame.
+     */
+    void process(shared_ptr<VideoFrame> videoFrame) override
+    {
+        processBatch(FrameSpan(&videoFrame, 1));
+    }
+
+    /**
+     * @brief queues records of detections of frames of a batch (one lock for whole batch).
+     * @param videoFrames(in): frames of batch.
+     */
+    void processBatch(FrameSpan videoFrames) override
+    {
+        unique_lock<mutex> lock(m_lock);
+        for (const auto &videoFrame : videoFrames)
+        {
+            videoFrame->m_overlay.snapshot(m_boxes);
+            if (m_boxes.empty())
+                continue;
+            if (m_readerGone)
+            {
+                m_stats.m_lostRecords += m_boxes.size();
+                continue;
+            }
+            if (!m_pending.empty() && (m_pending.size() + m_boxes.size() > m_bufferRecords))
+            {
+                // writer swaps buffers once previous one is written
+                m_flushRequested = true;
+                m_writerCv.notify_one();
+                m_stats.m_blockedFrames++;
+                m_pendingCv.wait(lock, [this] { return m_pending.empty(); });
+            }
+            const int64_t timestamp = chrono::duration_cast<chrono::nanoseconds>(videoFrame->m_captureTimestamp.time_since_epoch()).count();
+            for (const auto &box : m_boxes)
+                m_pending.push_back(DetectionRecord{videoFrame->m_sequenceNumber, timestamp, box.m_x, box.m_y, box.m_patternId,
+                                                    static_cast<uint16_t>(box.m_width), static_cast<uint16_t>(box.m_height)});
+            m_stats.m_events += m_boxes.size();
+        }
+        if (m_pending.size() >= m_bufferRecords)
+        {
+            m_flushRequested = true;
+            m_writerCv.notify_one();
+        }
+    }
+
+    /**
+     * @brief snapshot of sink counters.
+     * @return DetectionSinkStats.
+     */
+    DetectionSinkStats stats() const
+    {
+        lock_guard<mutex> lock(m_lock);
+        return m_stats;
+    }
+
+private:
+    /**
+     * @brief writer thread : swaps pending buffer when it is full (or cannot hold records of a frame),
+     * after flush interval or at stop, then writes it without lock.
+     */
+    void writeRecords()
+    {
+        unique_lock<mutex> lock(m_lock);
+        for (;;)
+        {
+            m_writerCv.wait_for(lock, m_flushInterval, [this] { return !m_running || m_flushRequested; });
+            m_flushRequested = false;
+            if (m_pending.empty())
+            {
+                if (!m_running)
+                    return;
+                continue;
+            }
+            swap(m_pending, m_writing);
+            m_pendingCv.notify_one();
+            lock.unlock();
+            // once reader of pipe is gone, records are dropped without write
+            const bool readerGone = m_readerGone;
+            const bool written = !readerGone && writeAll(m_writing.data(), m_writing.size() * sizeof(DetectionRecord));
+            const int error = errno;
+            if (!written && !readerGone)
+            {
+                if (error == EPIPE)
+                    MD_LOG(LogLevel::Info, "DetectionEventSink reader of output is gone, next records are dropped\n");
+                else
+                    MD_LOG(LogLevel::Info, "DetectionEventSink write failed : " << strerror(error) << "\n");
+            }
+            lock.lock();
+            if (written)
+            {
+                m_stats.m_written += m_writing.size();
+            }
+            else
+            {
+                m_stats.m_lostRecords += m_writing.size();
+                if (!readerGone)
+                    m_stats.m_writeErrors++;
+                m_readerGone = readerGone || (error == EPIPE);
+            }
+            m_stats.m_flushes++;
+            m_writing.clear();
+        }
+    }
+
+    /**
+     * @brief writes whole buffer to output (partial writes and interruptions are retried).
+     * @param data(in): bytes to write.
+     * @param size(in): number of bytes.
+     * @return bool: false on write error.
+     */
+    bool writeAll(const void *data, size_t size)
+    {
+        const char *bytes = static_cast<const char*>(data);
+        while (size)
+        {
+            const ssize_t count = write(m_fd, bytes, size);
+            if (count < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return false;
+            }
+            bytes += count;
+            size -= static_cast<size_t>(count);
+        }
+        return true;
+    }
+
+    size_t m_bufferRecords; /**< see constructor. */
+    FrameClock::duration m_flushInterval; /**< see constructor. */
+    int m_fd; /**< output descriptor. */
+    mutable mutex m_lock; /**< protects buffers, running state and counters. */
+    condition_variable m_writerCv; /**< wakes writer (full buffer or stop). */
+    condition_variable m_pendingCv; /**< wakes producer waiting for writer. */
+    bool m_running; /**< false once writer must write pending records and exit. */
+    bool m_flushRequested; /**< true when pending buffer must be written without waiting for flush interval. */
+    bool m_readerGone; /**< true once a write failed with EPIPE (reader of pipe exited), records are then dropped. */
+    vector<DetectionRecord> m_pending; /**< records queued by pipeline. */
+    vector<DetectionRecord> m_writing; /**< records written by writer, empty while writer waits. */
+    vector<DetectionBox> m_boxes; /**< detections of current frame, kept to reuse its capacity. */
+    DetectionSinkStats m_stats; /**< see stats. */
+    thread m_writer; /**< writer thread. */
+};
+
+/**
+ * @brief statistics of named elements : snapshot of all registered elements and periodic dump of their
+ * rates on stdout (frames per second, busy time in process, latencies, queue depth and drops) to find
+ * which stage saturates pipeline without a profiler. instrumentation of elements is enabled at start.
+ */
+class StatsReporter
+{
+public:
+    /**
+     * @brief StatsReporter constructor (no element, not started).
+     */
+    StatsReporter() : m_running(false)
+    {
+    }
+
+    /**
+     * @brief StatsReporter destructor : stops periodic dump.
+     */
+    ~StatsReporter()
+    {
+        stop();
+    }
+
+    /**
+     * @brief registers an element.
+     * @param name(in): name of element in snapshots and dumps.
+     * @param element(in): element outliving reporter (or its stop).
+     */
+    void add(const string &name, Element *element)
+    {
+        lock_guard<mutex> lock(m_lock);
+        m_elements.emplace_back(name, element);
+    }
+
+    /**
+     * @brief statistics of registered elements.
+     * @param resetPeaks(in): max values are reset.
+     * @return vector<ElementStats>: statistics in registration order.
+     */
+    vector<ElementStats> snapshot(bool resetPeaks = false)
+    {
+        lock_guard<mutex> lock(m_lock);
+        vector<ElementStats> snapshot;
+        for (const auto &element : m_elements)
+        {
+            snapshot.push_back(element.second->elementStats(resetPeaks));
+            snapshot.back().m_name = element.first;
+        }
+        return snapshot;
+    }
+
+    /**
+     * @brief formats rates of elements between two snapshots (one row per element).
+     * @param current(in): last snapshot.
+     * @param previous(in): previous snapshot of same elements, empty for rates since start.
+     * @param interval(in): time between snapshots.
+     * @return string: formatted table.
+     */
+    static string format(const vector<ElementStats> &current, const vector<ElementStats> &previous, FrameClock::duration interval)
+    {
+        const double seconds = max(chrono::duration<double>(interval).count(), 1e-9);
+        ostringstream out;
+        out << fixed << setprecision(1) << "***** STATS OVER " << seconds << " s ******\n"
+            << left << setw(16) << "element" << right << setw(10) << "in/s" << setw(10) << "out/s" << setw(8) << "busy %"
+            << setw(12) << "process us" << setw(12) << "max us" << setw(12) << "latency us" << setw(12) << "max us"
+            << setw(8) << "depth" << setw(10) << "dropped" << "\n";
+        for (size_t i = 0; i < current.size(); i++)
+        {
+            const ElementStats &now = current[i];
+            const ElementStats before = (i < previous.size()) ? previous[i] : ElementStats{};
+            const uint64_t framesIn = now.m_framesIn - before.m_framesIn;
+            const double processTime = double(now.m_processTime - before.m_processTime);
+            out << left << setw(16) << now.m_name << right
+                << setw(10) << framesIn / seconds << setw(10) << (now.m_framesOut - before.m_framesOut) / seconds
+                << setw(8) << processTime / (seconds * 1e7)
+                << setw(12) << (framesIn ? processTime / framesIn / 1e3 : 0.0) << setw(12) << now.m_maxProcessTime / 1e3
+                << setw(12) << (framesIn ? (now.m_latency - before.m_latency) / 1e3 / framesIn : 0.0) << setw(12) << now.m_maxLatency / 1e3;
+            if (now.m_queue)
+                out << setw(8) << now.m_queueDepth << setw(10) << (now.m_dropped - before.m_dropped);
+            else
+                out << setw(8) << "-" << setw(10) << "-";
+            out << "\n";
+        }
+        return out.str();
+    }
+
+    /**
+     * @brief enables instrumentation and starts periodic dump of rates since previous dump (max values
+     * are the ones of interval).
+     * @param period(in): time between two dumps.
+     */
+    void start(FrameClock::duration period)
+    {
+        ElementCounters::setEnabled(true);
+        lock_guard<mutex> lock(m_lock);
+        if (m_running)
+            return;
+        m_running = true;
+        m_thread = thread(&StatsReporter::dumpLoop, this, period);
+    }
+
+    /**
+     * @brief stops periodic dump if started (instrumentation stays enabled).
+     */
+    void stop()
+    {
+        {
+            lock_guard<mutex> lock(m_lock);
+            m_running = false;
+        }
+        m_cv.notify_all();
+        if (m_thread.joinable())
+            m_thread.join();
+    }
+
+private:
+    /**
+     * @brief method executed in dump thread : dumps rates every period until stop.
+     * @param period(in): time between two dumps.
+     */
+    void dumpLoop(FrameClock::duration period)
+    {
+        vector<ElementStats> previous = snapshot(true);
+        auto previousTime = FrameClock::now();
+        auto deadline = previousTime + period;
+        for (;;)
+        {
+            {
+                unique_lock<mutex> lock(m_lock);
+                if (m_cv.wait_until(lock, deadline, [this] { return !m_running; }))
+                    return;
+            }
+            vector<ElementStats> current = snapshot(true);
+            const auto now = FrameClock::now();
+            Logger::write(format(current, previous, now - previousTime));
+            previous = move(current);
+            previousTime = now;
+            deadline += period;
+        }
+    }
+
+    mutex m_lock; /**< protects elements and running state. */
+    condition_variable m_cv; /**< notified at stop. */
+    bool m_running; /**< true while dump thread runs. */
+    thread m_thread; /**< dump thread. */
+    vector<pair<string, Element*>> m_elements; /**< registered elements. */
+};
+
+/**
+ * @brief topologies of pipeline presets (see PipelineBuilder::build).
+ */
+enum class PipelineTopology : int
+{
+    DisplayOnly = 0,         /**< source -> display. */
+    DisplayWithDetector = 1, /**< source -> detector -> display, all elements in source thread. */
+    AsyncDetector = 2,       /**< source -> asynchronous queue -> detector and source -> display. */
+    MultiStream = 3          /**< streams of source -> stream queue -> detector, queues served by shared workers. */
+};
+
+/**
+ * @brief default topology, build flags DISPLAY_ONLY and DISPLAY_WITH_DETECTOR select former scenarios.
+ */
+#if defined(DISPLAY_ONLY)
+static constexpr PipelineTopology kDefaultTopology = PipelineTopology::DisplayOnly;
+#elif defined(DISPLAY_WITH_DETECTOR)
+static constexpr PipelineTopology kDefaultTopology = PipelineTopology::DisplayWithDetector;
+#else
+static constexpr PipelineTopology kDefaultTopology = PipelineTopology::AsyncDetector;
+#endif
+
+/**
+ * @brief frames generators of pipeline presets.
+ */
+enum class GeneratorKind : int
+{
+    Noise = 0,        /**< NoiseFrameGenerator. */
+    MovingObjects = 1, /**< MovingObjectsFrameGenerator with pattern as shape of objects. */
+    RawFile = 2, /**< MappedFileFrameGenerator replaying a raw frames file. */
+    RawStream = 3 /**< RawStreamFrameGenerator reading raw frames of a pipe or standard input. */
+};
+
+/**
+ * @brief options of a pipeline built by PipelineBuilder, default values are the ones of former main.
+ */
+struct PipelineConfig
+{
+    PipelineTopology m_topology = kDefaultTopology; /**< elements and links of pipeline. */
+    uint32_t m_width = 20; /**< width of frames. */
+    uint32_t m_height = 25; /**< height of frames. */
+    double m_frameRate = 1; /**< frames per second, VideoSourceElement::kUnthrottled for no pacing. */
+    PixelFormat m_pixelFormat = PixelFormat::Gray8; /**< pixels format of frames. */
+    size_t m_framePoolCapacity = VideoSourceElement::kDefaultFramePoolCapacity; /**< free list size of frame pool. */
+    GeneratorKind m_generator = GeneratorKind::Noise; /**< pixels generator of source. */
+    uint64_t m_seed = 0; /**< seed of generator, 0 for a random seed. */
+    size_t m_objectCount = 1; /**< moving objects of MovingObjects generator. */
+    bool m_staticBackground = false; /**< background of MovingObjects generator generated once. */
+    string m_input; /**< raw frames files (RawFile) or streams (RawStream, - for standard input), separated by commas. */
+    bool m_loopInput = false; /**< raw frames file replayed from its start once last frame is given. */
+    size_t m_readaheadFrames = MappedFileFrameGenerator::kDefaultReadaheadFrames; /**< frames of raw file requested ahead. */
+    vector<vector<uint8_t>> m_pattern{{0, 1, 0}, {1, 1, 1}, {0, 1, 0}, {1, 0, 1}}; /**< pattern to detect. */
+    bool m_motionDetector = false; /**< MotionDetectorElement inserted before detector. */
+    string m_eventsOutput; /**< output of DetectionEventSink inserted after detector, empty for no sink. */
+    DetectorConfig m_detector; /**< detector options (thread pool is created by builder). */
+    size_t m_detectorThreads = 0; /**< threads of pool scanning bands of frames, 0 to scan in detector thread. */
+    string m_kernels = "auto"; /**< SIMD kernels of pattern search (auto, scalar, sse2, avx2, neon). */
+    AsynchronousQueueConfig m_queue; /**< queue options (executor is set by builder). */
+    bool m_useExecutor = true; /**< source and queue run as tasks of an executor instead of dedicated threads. */
+    size_t m_executorWorkers = 0; /**< executor workers, 0 for one per core. */
+    size_t m_streams = 4; /**< sources of MultiStream topology. */
+    size_t m_streamWorkers = 0; /**< workers of StreamScheduler of MultiStream topology, 0 for one per core. */
+    size_t m_streamQueueSize = StreamQueue::kDefaultMaxSize; /**< frames queued per stream. */
+    size_t m_streamQuantum = 1; /**< frames of a stream forwarded per turn of its worker. */
+    vector<unsigned> m_sourceCpus; /**< cores of dedicated source threads (stream i on core i % size), empty for no pinning. */
+    vector<unsigned> m_executorCpus; /**< cores of executor workers, empty for no pinning. */
+    vector<unsigned> m_streamCpus; /**< cores of StreamScheduler workers, empty for no pinning. */
+    vector<unsigned> m_detectorCpus; /**< cores of threads scanning bands of frames, empty for no pinning. */
+    int m_frameNode = -1; /**< NUMA node of frames, -1 for node of allocating thread, kAutoFrameNode for node of consumer. */
+    static constexpr int kAutoFrameNode = -2; /**< frames on node of core of thread consuming them (detector). */
+    DisplayElement::Mode m_displayMode = DisplayElement::Mode::Scroll; /**< how frames are printed. */
+    double m_statsInterval = 0; /**< seconds between statistics dumps, 0 for no dump. */
+    LogLevel m_logLevel = LogLevel::Info; /**< runtime log level. */
+    StopMode m_stopMode = StopMode::Drain; /**< what queues do with their frames when process is stopped by a signal. */
+};
+
+/**
+ * @brief graph of elements owning them with executor and thread pool they use. elements are added
+ * with a name (used by statistics) and linked with Element::link. pipeline is destroyed sources first
+ * then in order of addition, so that upstream elements (added first) stop pushing before downstream
+ * ones are destroyed.
+ * pipeline is started without blocking (launch) and can be stopped from any thread, draining or
+ * discarding frames of its queues, then launched again (hot restart).
+ */
+class Pipeline
+{
+public:
+    /**
+     * @brief Pipeline destructor : stops sources (queued frames are discarded) then destroys elements
+     * in order of addition.
+     */
+    ~Pipeline()
+    {
+        m_statsReporter.stop();
+        stop(StopMode::Discard);
+        for (auto &element : m_elements)
+            element.second.reset();
+    }
+
+    /**
+     * @brief creates an element owned by pipeline.
+     * @param name(in): name of element, unique in pipeline.
+     * @param args(in): arguments of element constructor.
+     * @return T: pointer to element, valid while pipeline exists.
+     */
+    template <typename T, typename... Args>
+    T* add(const string &name, Args&&... args)
+    {
+        if (find(name))
+            throw invalid_argument("pipeline element already exists : " + name);
+        auto element = make_unique<T>(forward<Args>(args)...);
+        T *pointer = element.get();
+        if constexpr (is_base_of<VideoSourceElement, T>::value)
+            m_sources.push_back(pointer);
+        if constexpr (is_base_of<AsynchronousQueue, T>::value || is_base_of<StreamQueue, T>::value)
+            m_queueStops.push_back([pointer](StopMode mode) { pointer->stop(mode); });
+        m_statsReporter.add(name, pointer);
+        m_elements.emplace_back(name, move(element));
+        return pointer;
+    }
+
+    /**
+     * @brief element of pipeline.
+     * @param name(in): name of element.
+     * @return BaseElement: pointer to element, null if no element has this name.
+     */
+    BaseElement* find(const string &name) const
+    {
+        for (const auto &element : m_elements)
+            if (element.first == name)
+                return element.second.get();
+        return nullptr;
+    }
+
+    /**
+     * @brief executor of pipeline, created at first call.
+     * @param workers(in): workers of executor when created (0 for one per core).
+     * @param cpus(in): cores of workers when created, empty for no pinning.
+     * @return PipelineExecutor.
+     */
+    PipelineExecutor* executor(size_t workers = 0, const vector<unsigned> &cpus = {})
+    {
+        if (!m_executor)
+            m_executor = make_unique<PipelineExecutor>(workers, cpus);
+        return m_executor.get();
+    }
+
+    /**
+     * @brief stream scheduler of pipeline, created at first call.
+     * @param workers(in): workers of scheduler when created (0 for one per core).
+     * @param quantum(in): frames of a stream forwarded per turn when created.
+     * @param cpus(in): cores of workers when created, empty for no pinning.
+     * @return StreamScheduler.
+     */
+    StreamScheduler* streamScheduler(size_t workers, size_t quantum, const vector<unsigned> &cpus = {})
+    {
+        if (!m_streamScheduler)
+            m_streamScheduler = make_unique<StreamScheduler>(workers, quantum, cpus);
+        return m_streamScheduler.get();
+    }
+
+    /**
+     * @brief thread pool of pipeline, created at first call.
+     * @param threads(in): threads of pool when created.
+     * @param cpus(in): cores of threads when created, empty for no pinning.
+     * @return ThreadPool.
+     */
+    ThreadPool* threadPool(size_t threads, const vector<unsigned> &cpus = {})
+    {
+        if (!m_threadPool)
+            m_threadPool = make_unique<ThreadPool>(threads, cpus);
+        return m_threadPool.get();
+    }
+
+    /**
+     * @brief statistics of named elements of pipeline.
+     * @return StatsReporter.
+     */
+    StatsReporter& statsReporter()
+    {
+        return m_statsReporter;
+    }
+
+    /**
+     * @brief starts sources of pipeline, blocked until they are stopped (see launch and wait).
+     */
+    void start()
+    {
+        launch();
+        wait();
+    }
+
+    /**
+     * @brief starts sources of pipeline without waiting for them (see VideoSourceElement::launch).
+     */
+    void launch()
+    {
+        const auto begin = FrameClock::now();
+        m_stopRequested = false;
+        for (auto source : m_sources)
+            source->launch();
+        const double microseconds = chrono::duration<double, micro>(FrameClock::now() - begin).count();
+        MD_LOG(LogLevel::Debug, "Pipeline launched in " << microseconds << " us\n");
+    }
+
+    /**
+     * @brief blocks until sources of pipeline are stopped or exhausted, from any number of threads.
+     * when sources end by themselves (end of recorded streams), queues are drained so that last frames
+     * reach every element.
+     */
+    void wait()
+    {
+        for (auto source : m_sources)
+            source->wait();
+        if (!m_stopRequested)
+            stopQueues(StopMode::Drain);
+    }
+
+    /**
+     * @brief stops sources of pipeline at once, then its queues (upstream ones first).
+     * @param mode(in): Drain forwards frames already queued to their elements, Discard releases them.
+     * @return FrameClock::duration: shutdown latency (until queues are stopped).
+     */
+    FrameClock::duration stop(StopMode mode = StopMode::Drain)
+    {
+        const auto begin = FrameClock::now();
+        m_stopRequested = true;
+        for (auto source : m_sources)
+            source->requestStop();
+        for (auto source : m_sources)
+            source->wait();
+        stopQueues(mode);
+        return FrameClock::now() - begin;
+    }
+
+private:
+    unique_ptr<PipelineExecutor> m_executor; /**< executor of sources and queues, destroyed after elements. */
+    unique_ptr<ThreadPool> m_threadPool; /**< pool of detectors, destroyed after elements. */
+    unique_ptr<StreamScheduler> m_streamScheduler; /**< workers of stream queues, destroyed after elements. */
+    StatsReporter m_statsReporter; /**< statistics of elements. */
+    vector<pair<string, unique_ptr<BaseElement>>> m_elements; /**< elements in order of addition. */
+    vector<VideoSourceElement*> m_sources; /**< sources of pipeline. */
+    vector<function<void(StopMode)>> m_queueStops; /**< stop of queues of pipeline, in order of addition. */
+    atomic<bool> m_stopRequested{false}; /**< stop was called since last launch. */
+
+    /**
+     * @brief stops queues of pipeline (sources must be stopped).
+     * @param mode(in): see stop.
+     */
+    void stopQueues(StopMode mode)
+    {
+        for (const auto &stopQueue : m_queueStops)
+            stopQueue(mode);
+    }
+};
+
+/**
+ * @brief builds pipelines from PipelineConfig, parsed from command line options and configuration
+ * files (see usage), so that topologies and their parameters are chosen at startup.
+ */
+class PipelineBuilder
+{
+public:
+    /**
+     * @brief options description.
+     * @return string: usage text.
+     */
+    static string usage()
+    {
+        return "options (also lines key=value of --config file, # starts a comment) :\n"
+               "  --config=file                                     reads options of file\n"
+               "  --topology=display-only|display-with-detector|async-detector|multi-stream\n"
+               "  --width=pixels --height=pixels                    frames size\n"
+               "  --frame-rate=fps                                  0 for unthrottled source\n"
+               "  --pixel-format=gray8|mono1                        pixels format of frames\n"
+               "  --frame-pool=frames                               free list size of frame pool\n"
+               "  --generator=noise|motion|raw-file|raw-stream      pixels generator\n"
+               "  --seed=value --objects=count --static-background=0|1   generator options\n"
+               "  --input=path[,path...] --loop=0|1 --readahead=frames   raw frames files or streams (- for stdin)\n"
+               "  --pattern=010,111,010,101                         pattern rows separated by commas\n"
+               "  --motion-detector=0|1                             motion detector before detector\n"
+               "  --events=path                                     binary detection events written after detector\n"
+               "  --matcher=auto|fixed|bitmask|bytewise|summed-area pattern matcher\n"
+               "  --kernels=auto|scalar|sse2|avx2|neon              SIMD kernels of pattern search\n"
+               "  --marking=overlay|pixels                          how found patterns are marked\n"
+               "  --detection=all|first|count|top-k --max-matches=k   matches searched, logged and marked per frame\n"
+               "  --detector-threads=threads                        threads scanning bands of frames\n"
+               "  --queue-size=frames --queue-batch=frames          asynchronous queue size and batch\n"
+               "  --queue-mode=locked|spsc --wait-strategy=spin|spin-then-park|futex\n"
+               "  --queue-policy=auto|drop-oldest|drop-newest|block|keep-every-nth --keep-every=n   (spsc : auto|drop-newest|block)\n"
+               "  --threads=executor|dedicated --executor-workers=workers   threads of source and queue\n"
+               "  --streams=count --stream-workers=workers          sources and shared detector workers of multi-stream\n"
+               "  --stream-queue-size=frames --stream-quantum=frames   per stream queue and frames per turn\n"
+               "  --source-cpus=list --queue-cpus=list              cores of dedicated source and queue threads (0-3,8)\n"
+               "  --executor-cpus=list --stream-cpus=list --detector-cpus=list   cores of workers of pools\n"
+               "  --frame-node=none|auto|node                       NUMA node of frames (auto : node of consumer)\n"
+               "  --display=scroll|in-place                         how frames are printed\n"
+               "  --stats-interval=seconds                          periodic dump of elements statistics\n"
+               "  --stop-mode=drain|discard                         queued frames at SIGINT/SIGTERM shutdown\n"
+               "  --log-level=quiet|info|debug|trace\n";
+    }
+
+    /**
+     * @brief parses options (--key=value) in config, throws invalid_argument on unknown option or value.
+     * @param arguments(in): options.
+     * @param config(in/out): options of pipeline.
+     */
+    static void parseArguments(const vector<string> &arguments, PipelineConfig &config)
+    {
+        for (const auto &argument : arguments)
+        {
+            const size_t equal = argument.find('=');
+            if ((argument.compare(0, 2, "--") != 0) || (equal == string::npos))
+                throw invalid_argument("option must be --key=value : " + argument);
+            parseOption(argument.substr(2, equal - 2), argument.substr(equal + 1), config);
+        }
+    }
+
+    /**
+     * @brief builds pipeline of config topology.
+     * @param config(in): options of pipeline, throws invalid_argument for inconsistent ones.
+     * @return Pipeline: elements of topology (source named "source", then "display", "queue",
+     * "motion", "detector", "events", multi-stream elements are suffixed by stream index).
+     */
+    static unique_ptr<Pipeline> build(const PipelineConfig &config)
+    {
+        // first and count detections never mark frames
+        const bool marksFrames = (config.m_detector.m_detectionMode == DetectionMode::All) ||
+                                 (config.m_detector.m_detectionMode == DetectionMode::TopK);
+        if ((config.m_topology == PipelineTopology::AsyncDetector) && marksFrames && (config.m_detector.m_markingMode == MarkingMode::Pixels))
+            throw invalid_argument("pixels marking alters frames displayed concurrently, use overlay marking with async-detector topology");
+        if (!config.m_eventsOutput.empty() && !marksFrames)
+            throw invalid_argument("detection events are read from frame overlay, use all or top-k detection with --events");
+        if (!config.m_eventsOutput.empty() && (config.m_detector.m_markingMode == MarkingMode::Pixels))
+            throw invalid_argument("detection events are read from frame overlay, use overlay marking with --events");
+        selectKernels(config.m_kernels);
+
+        auto pipeline = make_unique<Pipeline>();
+        if (config.m_topology == PipelineTopology::MultiStream)
+        {
+            buildMultiStream(*pipeline, config);
+            return pipeline;
+        }
+        VideoSourceElement *source = addSource(*pipeline, config, 0, "source");
+        source->setNumaNode(frameNode(config, config.m_useExecutor ? config.m_executorCpus : config.m_sourceCpus));
+        DisplayElement *display = pipeline->add<DisplayElement>("display", config.m_displayMode);
+
+        if (config.m_topology == PipelineTopology::DisplayOnly)
+        {
+            //    ******************           *******************
+            //    *                *           *                 *
+            //    *  VIDEO SOURCE  ***********>*     DISPLAY     *
+            //    *                *           *                 *
+            //    ******************           *******************
+            source->link(display);
+            return pipeline;
+        }
+
+        if (config.m_topology == PipelineTopology::DisplayWithDetector)
+        {
+            //    ******************           *******************           *******************
+            //    *                *           *                 *           *                 *
+            //    *  VIDEO SOURCE  ***********>*     DETECTOR    ***********>*     DISPLAY     *
+            //    *                *           *                 *           *                 *
+            //    ******************           *******************           *******************
+            addDetector(*pipeline, addMotionDetector(*pipeline, source, config), config)->link(display);
+            return pipeline;
+        }
+
+        //to avoid that detector bloque display we use asynchronous queue for dispatching samples
+        //    ******************           *******************           *******************
+        //    *                *           *                 *           *                 *
+        //    *  VIDEO SOURCE  ***********>*   AsyncQueue    ***********>*     DETECTOR    *
+        //    *                *     *     *                 *           *                 *
+        //    ******************     *     *******************           *******************
+        //                           *
+        //                           *     *******************
+        //                           *     *                 *
+        //                           *****>*   DISPLAY       *
+        //                                 *                 *
+        //                                 *******************
+        // motion detector (if enabled) is inserted between source and branches : frame changes
+        // are computed before frame is shared by queue and display threads
+        AsynchronousQueueConfig queueConfig = config.m_queue;
+        queueConfig.m_executor = config.m_useExecutor ? pipeline->executor(config.m_executorWorkers, config.m_executorCpus) : nullptr;
+        if (config.m_frameNode == PipelineConfig::kAutoFrameNode)
+            source->setNumaNode(frameNode(config, config.m_useExecutor ? config.m_executorCpus : config.m_queue.m_cpus));
+        AsynchronousQueue *queue = pipeline->add<AsynchronousQueue>("queue", queueConfig);
+        Element *branches = addMotionDetector(*pipeline, source, config);
+        branches->link(queue);
+        addDetector(*pipeline, queue, config);
+        branches->link(display);
+        return pipeline;
+    }
+
+private:
+    /**
+     * @brief parses one option.
+     * @param key(in): option name without leading dashes.
+     * @param value(in): option value.
+     * @param config(in/out): options of pipeline.
+     */
+    static void parseOption(const string &key, const string &value, PipelineConfig &config)
+    {
+        if (key == "config")
+            parseConfigFile(value, config);
+        else if (key == "topology")
+            config.m_topology = parseName<PipelineTopology>(key, value, {{"display-only", PipelineTopology::DisplayOnly},
+                    {"display-with-detector", PipelineTopology::DisplayWithDetector}, {"async-detector", PipelineTopology::AsyncDetector},
+                    {"multi-stream", PipelineTopology::MultiStream}});
+        else if (key == "width")
+            config.m_width = static_cast<uint32_t>(parseCount(key, value, 1, UINT32_MAX));
+        else if (key == "height")
+            config.m_height = static_cast<uint32_t>(parseCount(key, value, 1, UINT32_MAX));
+        else if (key == "frame-rate")
+            config.m_frameRate = parseNumber(key, value);
+        else if (key == "pixel-format")
+            config.m_pixelFormat = parseName<PixelFormat>(key, value, {{"gray8", PixelFormat::Gray8}, {"mono1", PixelFormat::Mono1}});
+        else if (key == "frame-pool")
+            config.m_framePoolCapacity = parseCount(key, value, 0, SIZE_MAX);
+        else if (key == "generator")
+            config.m_generator = parseName<GeneratorKind>(key, value, {{"noise", GeneratorKind::Noise}, {"motion", GeneratorKind::MovingObjects},
+                    {"raw-file", GeneratorKind::RawFile}, {"raw-stream", GeneratorKind::RawStream}});
+        else if (key == "input")
+            config.m_input = value;
+        else if (key == "loop")
+            config.m_loopInput = parseBool(key, value);
+        else if (key == "readahead")
+            config.m_readaheadFrames = parseCount(key, value, 0, SIZE_MAX);
+        else if (key == "seed")
+            config.m_seed = parseCount(key, value, 0, UINT64_MAX);
+        else if (key == "objects")
+            config.m_objectCount = parseCount(key, value, 1, SIZE_MAX);
+        else if (key == "static-background")
+            config.m_staticBackground = parseBool(key, value);
+        else if (key == "pattern")
+            config.m_pattern = parsePattern(value);
+        else if (key == "motion-detector")
+            config.m_motionDetector = parseBool(key, value);
+        else if (key == "events")
+            config.m_eventsOutput = value;
+        else if (key == "matcher")
+            config.m_detector.m_matcherKind = parseName<MatcherKind>(key, value, {{"auto", MatcherKind::Auto}, {"fixed", MatcherKind::Fixed},
+                    {"bitmask", MatcherKind::Bitmask}, {"bytewise", MatcherKind::Bytewise}, {"summed-area", MatcherKind::SummedArea}});
+        else if (key == "kernels")
+            config.m_kernels = value;
+        else if (key == "marking")
+            config.m_detector.m_markingMode = parseName<MarkingMode>(key, value, {{"overlay", MarkingMode::Overlay}, {"pixels", MarkingMode::Pixels}});
+        else if (key == "detection")
+            config.m_detector.m_detectionMode = parseName<DetectionMode>(key, value, {{"all", DetectionMode::All}, {"first", DetectionMode::FirstMatch},
+                    {"count", DetectionMode::CountOnly}, {"top-k", DetectionMode::TopK}});
+        else if (key == "max-matches")
+            config.m_detector.m_maxMatches = parseCount(key, value, 1, SIZE_MAX);
+        else if (key == "detector-threads")
+            config.m_detectorThreads = parseCount(key, value, 0, SIZE_MAX);
+        else if (key == "queue-size")
+            config.m_queue.m_maxSize = parseCount(key, value, 1, SIZE_MAX);
+        else if (key == "queue-batch")
+            config.m_queue.m_maxBatchSize = parseCount(key, value, 1, SIZE_MAX);
+        else if (key == "queue-mode")
+            config.m_queue.m_mode = parseName<QueueMode>(key, value, {{"locked", QueueMode::Locked}, {"spsc", QueueMode::Spsc}});
+        else if (key == "wait-strategy")
+            config.m_queue.m_waitStrategy = parseName<WaitStrategy>(key, value, {{"spin", WaitStrategy::Spin},
+                    {"spin-then-park", WaitStrategy::SpinThenPark}, {"futex", WaitStrategy::Futex}});
+        else if (key == "queue-policy")
+            config.m_queue.m_policy = parseName<BackpressurePolicy>(key, value, {{"auto", BackpressurePolicy::Auto},
+                    {"drop-oldest", BackpressurePolicy::DropOldest}, {"drop-newest", BackpressurePolicy::DropNewest},
+                    {"block", BackpressurePolicy::BlockProducer}, {"keep-every-nth", BackpressurePolicy::KeepEveryNth}});
+        else if (key == "keep-every")
+            config.m_queue.m_keepEveryNth = parseCount(key, value, 1, SIZE_MAX);
+        else if (key == "threads")
+            config.m_useExecutor = parseName<bool>(key, value, {{"executor", true}, {"dedicated", false}});
+        else if (key == "executor-workers")
+            config.m_executorWorkers = parseCount(key, value, 0, SIZE_MAX);
+        else if (key == "streams")
+            config.m_streams = parseCount(key, value, 1, SIZE_MAX);
+        else if (key == "stream-workers")
+            config.m_streamWorkers = parseCount(key, value, 0, SIZE_MAX);
+        else if (key == "stream-queue-size")
+            config.m_streamQueueSize = parseCount(key, value, 1, SIZE_MAX);
+        else if (key == "stream-quantum")
+            config.m_streamQuantum = parseCount(key, value, 1, SIZE_MAX);
+        else if (key == "source-cpus")
+            config.m_sourceCpus = CpuAffinity::parseCpuList(value);
+        else if (key == "queue-cpus")
+            config.m_queue.m_cpus = CpuAffinity::parseCpuList(value);
+        else if (key == "executor-cpus")
+            config.m_executorCpus = CpuAffinity::parseCpuList(value);
+        else if (key == "stream-cpus")
+            config.m_streamCpus = CpuAffinity::parseCpuList(value);
+        else if (key == "detector-cpus")
+            config.m_detectorCpus = CpuAffinity::parseCpuList(value);
+        else if (key == "frame-node")
+            config.m_frameNode = (value == "none") ? -1 : (value == "auto") ? PipelineConfig::kAutoFrameNode :
+                    static_cast<int>(parseCount(key, value, 0, sizeof(unsigned long) * CHAR_BIT - 1));
+        else if (key == "display")
+            config.m_displayMode = parseName<DisplayElement::Mode>(key, value, {{"scroll", DisplayElement::Mode::Scroll},
+                    {"in-place", DisplayElement::Mode::InPlace}});
+        else if (key == "stats-interval")
+            config.m_statsInterval = parseNumber(key, value);
+        else if (key == "log-level")
+            config.m_logLevel = Logger::parseLevel(value);
+        else if (key == "stop-mode")
+            config.m_stopMode = parseName<StopMode>(key, value, {{"drain", StopMode::Drain}, {"discard", StopMode::Discard}});
+        else
+            throw invalid_argument("unknown option --" + key);
+    }
+
+    /**
+     * @brief parses options of a configuration file : one key=value per line, empty lines and lines
+     * starting with # are ignored, config=path lines include other files (a file including itself,
+     * directly or not, throws invalid_argument).
+     * @param path(in): path of file.
+     * @param config(in/out): options of pipeline.
+     * @param openFiles(in): resolved paths of files including this one.
+     */
+    static void parseConfigFile(const string &path, PipelineConfig &config, vector<string> openFiles = {})
+    {
+        ifstream file(path);
+        if (!file)
+            throw invalid_argument("cannot read config file " + path);
+        char *resolved = realpath(path.c_str(), nullptr);
+        const string resolvedPath = resolved ? resolved : path;
+        free(resolved);
+        if (find(openFiles.begin(), openFiles.end(), resolvedPath) != openFiles.end())
+            throw invalid_argument("config file includes itself : " + path);
+        openFiles.push_back(resolvedPath);
+        string line;
+        while (getline(file, line))
+        {
+            line.erase(0, line.find_first_not_of(" \t"));
+            line.erase(line.find_last_not_of(" \t\r") + 1);
+            if (line.empty() || (line[0] == '#'))
+                continue;
+            if (line.compare(0, 7, "config=") == 0)
+                parseConfigFile(line.substr(7), config, openFiles);
+            else
+                parseArguments({"--" + line}, config);
+        }
+    }
+
+    /**
+     * @brief value of a named option.
+     * @param key(in): option name (for error message).
+     * @param value(in): option value.
+     * @param names(in): accepted values.
+     * @return T: value of name.
+     */
+    template <typename T>
+    static T parseName(const string &key, const string &value, initializer_list<pair<const char*, T>> names)
+    {
+        for (const auto &name : names)
+            if (value == name.first)
+                return name.second;
+        throw invalid_argument("unknown value of --" + key + " : " + value);
+    }
+
+    /**
+     * @brief integer value of an option.
+     * @param key(in): option name (for error message).
+     * @param value(in): option value.
+     * @param minimum(in): min accepted value.
+     * @param maximum(in): max accepted value.
+     * @return uint64_t: value.
+     */
+    static uint64_t parseCount(const string &key, const string &value, uint64_t minimum, uint64_t maximum)
+    {
+        size_t end = 0;
+        unsigned long long count = 0;
+        try
+        {
+            count = stoull(value, &end);
+        } catch (const exception &)
+        {
+            end = 0;
+        }
+        if ((end == 0) || (end != value.size()) || (value[0] == '-') || (count < minimum) || (count > maximum))
+            throw invalid_argument("invalid value of --" + key + " : " + value);
+        return count;
+    }
+
+    /**
+     * @brief non negative number value of an option.
+     * @param key(in): option name (for error message).
+     * @param value(in): option value.
+     * @return double: value.
+     */
+    static double parseNumber(const string &key, const string &value)
+    {
+        size_t end = 0;
+        double number = -1;
+        try
+        {
+            number = stod(value, &end);
+        } catch (const exception &)
+        {
+            end = 0;
+        }
+        if ((end == 0) || (end != value.size()) || !(number >= 0))
+            throw invalid_argument("invalid value of --" + key + " : " + value);
+        return number;
+    }
+
+    /**
+     * @brief boolean value of an option (0, 1, false, true, off, on).
+     */
+    static bool parseBool(const string &key, const string &value)
+    {
+        return parseName<bool>(key, value, {{"0", false}, {"1", true}, {"false", false}, {"true", true}, {"off", false}, {"on", true}});
+    }
+
+    /**
+     * @brief pattern of rows of digits separated by commas (for instance 010,111,010,101).
+     * @param value(in): option value.
+     * @return vector<vector<uint8_t>>: rectangular pattern.
+     */
+    static vector<vector<uint8_t>> parsePattern(const string &value)
+    {
+        vector<vector<uint8_t>> pattern(1);
+        for (const char c : value)
+        {
+            if (c == ',')
+                pattern.emplace_back();
+            else if ((c >= '0') && (c <= '9'))
+                pattern.back().push_back(static_cast<uint8_t>(c - '0'));
+            else
+                throw invalid_argument("invalid pattern : " + value);
+        }
+        for (const auto &row : pattern)
+            if (row.empty() || (row.size() != pattern[0].size()))
+                throw invalid_argument("pattern rows must be non empty and of same size : " + value);
+        return pattern;
+    }
+
+    /**
+     * @brief selects SIMD kernels of pattern search by name.
+     * @param kernels(in): auto (best kernels of cpu), scalar, sse2, avx2 or neon.
+     */
+    static void selectKernels(const string &kernels)
+    {
+        if (kernels == "auto")
+            return;
+        for (const auto level : {SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2, SimdLevel::Neon})
+        {
+            if (kernels != SimdKernels::levelName(level))
+                continue;
+            if (!SimdKernels::select(level))
+                throw invalid_argument("kernels not supported by build or cpu : " + kernels);
+            return;
+        }
+        throw invalid_argument("unknown kernels : " + kernels);
+    }
+
+    /**
+     * @brief pixels generator of source.
+     * @param config(in): options of pipeline.
+     * @param stream(in): index of source (offset of seed, index of input of raw generators).
+     * @return FrameGenerator.
+     */
+    static unique_ptr<FrameGenerator> createGenerator(const PipelineConfig &config, size_t stream)
+    {
+        const uint64_t seed = config.m_seed ? (config.m_seed + stream) : random_device{}();
+        if (config.m_generator == GeneratorKind::Noise)
+            return make_unique<NoiseFrameGenerator>(seed);
+        if ((config.m_generator == GeneratorKind::RawFile) || (config.m_generator == GeneratorKind::RawStream))
+        {
+            vector<string> inputs;
+            istringstream list(config.m_input);
+            for (string input; getline(list, input, ',');)
+                if (!input.empty())
+                    inputs.push_back(input);
+            if (inputs.empty())
+                throw invalid_argument("raw frames generators need --input");
+            if (config.m_generator == GeneratorKind::RawStream)
+            {
+                // a stream is read by one source only
+                if (stream >= inputs.size())
+                    throw invalid_argument("raw frames streams need one --input per stream");
+                return make_unique<RawStreamFrameGenerator>(inputs[stream], config.m_width, config.m_height);
+            }
+            return make_unique<MappedFileFrameGenerator>(inputs[stream % inputs.size()], config.m_width, config.m_height,
+                                                         config.m_loopInput, config.m_readaheadFrames);
+        }
+        MotionSceneConfig scene;
+        scene.m_seed = seed;
+        scene.m_objectCount = config.m_objectCount;
+        scene.m_shapes = {config.m_pattern};
+        scene.m_staticBackground = config.m_staticBackground;
+        return make_unique<MovingObjectsFrameGenerator>(scene);
+    }
+
+    /**
+     * @brief adds a source.
+     * @param pipeline(in/out): pipeline.
+     * @param config(in): options of pipeline.
+     * @param stream(in): index of stream (seed offset and input of generator).
+     * @param name(in): name of source.
+     * @return VideoSourceElement: added source.
+     */
+    static VideoSourceElement* addSource(Pipeline &pipeline, const PipelineConfig &config, size_t stream, const string &name)
+    {
+        VideoSourceElement *source = pipeline.add<VideoSourceElement>(name, config.m_width, config.m_height, config.m_frameRate,
+                                                                      config.m_framePoolCapacity);
+        source->setPixelFormat(config.m_pixelFormat);
+        source->setFrameGenerator(createGenerator(config, stream));
+        if (config.m_useExecutor)
+            source->setExecutor(pipeline.executor(config.m_executorWorkers, config.m_executorCpus));
+        else if (!config.m_sourceCpus.empty())
+            source->setAffinity((config.m_topology == PipelineTopology::MultiStream) ?
+                    vector<unsigned>{config.m_sourceCpus[stream % config.m_sourceCpus.size()]} : config.m_sourceCpus);
+        return source;
+    }
+
+    /**
+     * @brief NUMA node of frames of a source.
+     * @param config(in): options of pipeline.
+     * @param consumerCpus(in): cores of thread consuming frames, for automatic node.
+     * @return int: node, -1 for node of allocating thread.
+     */
+    static int frameNode(const PipelineConfig &config, const vector<unsigned> &consumerCpus)
+    {
+        if (config.m_frameNode != PipelineConfig::kAutoFrameNode)
+            return config.m_frameNode;
+        return consumerCpus.empty() ? -1 : CpuAffinity::nodeOfCpu(consumerCpus.front());
+    }
+
+    /**
+     * @brief adds motion detector after an element if enabled, it must precede every branch reading frame changes.
+     * @param pipeline(in/out): pipeline.
+     * @param upstream(in): element feeding motion detector.
+     * @param config(in): options of pipeline.
+     * @param suffix(in): suffix of name of motion detector (stream index).
+     * @return Element: motion detector, or upstream when it is disabled.
+     */
+    static Element* addMotionDetector(Pipeline &pipeline, Element *upstream, const PipelineConfig &config, const string &suffix = "")
+    {
+        if (!config.m_motionDetector)
+            return upstream;
+        return upstream->link(pipeline.add<MotionDetectorElement>("motion" + suffix));
+    }
+
+    /**
+     * @brief adds detector (and events sink after it if enabled) after an element.
+     * @param pipeline(in/out): pipeline.
+     * @param upstream(in): element feeding detector.
+     * @param config(in): options of pipeline.
+     * @param suffix(in): suffix of names of added elements (stream index), events sink is shared.
+     * @return Element: last added element.
+     */
+    static Element* addDetector(Pipeline &pipeline, Element *upstream, const PipelineConfig &config, const string &suffix = "")
+    {
+        DetectorConfig detectorConfig = config.m_detector;
+        if (config.m_detectorThreads)
+            detectorConfig.m_threadPool = pipeline.threadPool(config.m_detectorThreads, config.m_detectorCpus);
+        Element *detector = upstream->link(pipeline.add<DetectorElement>("detector" + suffix, config.m_pattern, detectorConfig));
+        if (config.m_eventsOutput.empty())
+            return detector;
+        Element *events = pipeline.find("events");
+        return detector->link(events ? events : pipeline.add<DetectionEventSink>("events", config.m_eventsOutput));
+    }
+
+    /**
+     * @brief adds streams of multi-stream topology : each source feeds its stream queue and
+     * detector, stream queues are forwarded by shared workers of a StreamScheduler.
+     *    ******************           *******************           *******************
+     *    *  VIDEO SOURCE i ***********>*  STREAM QUEUE i ***********>*   DETECTOR i    *
+     *    ******************           ********+**********           *******************
+     *                                         +  shard of StreamScheduler (worker i % workers)
+     * @param pipeline(in/out): pipeline.
+     * @param config(in): options of pipeline.
+     */
+    static void buildMultiStream(Pipeline &pipeline, const PipelineConfig &config)
+    {
+        StreamScheduler *scheduler = pipeline.streamScheduler(config.m_streamWorkers, config.m_streamQuantum, config.m_streamCpus);
+        for (size_t stream = 0; stream < config.m_streams; stream++)
+        {
+            const string suffix = to_string(stream);
+            VideoSourceElement *source = addSource(pipeline, config, stream, "source" + suffix);
+            StreamQueue *queue = pipeline.add<StreamQueue>("queue" + suffix, *scheduler, config.m_streamQueueSize);
+            // detector of stream runs on worker of shard of its queue
+            source->setNumaNode((config.m_frameNode == PipelineConfig::kAutoFrameNode) ?
+                    scheduler->numaNode(queue->shardIndex()) : config.m_frameNode);
+            source->link(queue);
+            addDetector(pipeline, addMotionDetector(pipeline, queue, config, suffix), config, suffix);
+        }
+    }
+};
+
+/**
+ * @brief stops a pipeline when process receives SIGINT or SIGTERM (rolling restarts) : signals are
+ * blocked in every thread (see blockSignals) and waited by a dedicated thread, so that pipeline is
+ * stopped out of any signal handler.
+ */
+class SignalStopper
+{
+public:
+    /**
+     * @brief blocks shutdown signals in calling thread and threads created after, to be called
+     * before pipeline is built.
+     */
+    static void blockSignals()
+    {
+        const sigset_t signals = shutdownSignals();
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    }
+
+    /**
+     * @brief SignalStopper constructor : starts thread waiting for shutdown signals.
+     * @param pipeline(in): pipeline outliving stopper.
+     * @param mode(in): what queues of pipeline do with their frames.
+     */
+    SignalStopper(Pipeline &pipeline, StopMode mode) :
+            m_thread(&SignalStopper::waitSignal, &pipeline, mode)
+    {
+    }
+
+    /**
+     * @brief SignalStopper destructor : ends waiting thread (SIGUSR1 sent to it) without stopping pipeline.
+     */
+    ~SignalStopper()
+    {
+        pthread_kill(m_thread.native_handle(), SIGUSR1);
+        m_thread.join();
+    }
+
+    SignalStopper(const SignalStopper &) = delete;
+    SignalStopper& operator=(const SignalStopper &) = delete;
+
+private:
+    thread m_thread; /**< thread waiting for signals. */
+
+    /**
+     * @brief signals waited by stopper.
+     * @return sigset_t: SIGINT, SIGTERM and SIGUSR1 (end of stopper).
+     */
+    static sigset_t shutdownSignals()
+    {
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        sigaddset(&signals, SIGUSR1);
+        return signals;
     }
 
     /**
-     * @brief process frame : it will start thread for queue management
-     * if not started and then add new frame in queue.
-     * @param videoFrame(in): shared pointer of video frame.
-     * @return void.
+     * @brief method executed in stopper thread : stops pipeline at first shutdown signal.
+     * @param pipeline(in): pipeline.
+     * @param mode(in): see constructor.
+     */
+    static void waitSignal(Pipeline *pipeline, StopMode mode)
+    {
+        const sigset_t signals = shutdownSignals();
+        int signal = 0;
+        if ((sigwait(&signals, &signal) != 0) || (signal == SIGUSR1))
+            return;
+        const double milliseconds = chrono::duration<double, milli>(pipeline->stop(mode)).count();
+        MD_LOG(LogLevel::Info, "Pipeline stopped by signal " << signal << " in " << milliseconds << " ms\n");
+    }
+};
+
+#if defined(MOTIONDETECTOR_BENCH)
+/**
+ * @brief measures of one benchmark case.
+ */
+struct BenchmarkResult
+{
+    string m_name; /**< benchmarked path (generate, detect, queue, pipeline). */
+    string m_variant; /**< options of case (generator, matcher, queue mode, topology, pixels format). */
+    uint32_t m_width; /**< width of frames. */
+    uint32_t m_height; /**< height of frames. */
+    size_t m_patternRows; /**< rows of searched pattern, 0 without detection. */
+    size_t m_patternColumns; /**< columns of searched pattern, 0 without detection. */
+    uint64_t m_frames; /**< measured frames. */
+    double m_seconds; /**< wall time of measured frames. */
+    double m_p50Microseconds; /**< median latency of a frame. */
+    double m_p99Microseconds; /**< 99th percentile latency of a frame. */
+
+    /**
+     * @brief throughput of case.
+     * @return double: frames per second.
+     */
+    double framesPerSecond() const
+    {
+        return (m_seconds > 0) ? m_frames / m_seconds : 0;
+    }
+
+    /**
+     * @brief cost of case per pixel of frames.
+     * @return double: nanoseconds per pixel.
      */
+    double nanosecondsPerPixel() const
+    {
+        const double pixels = double(m_frames) * m_width * m_height;
+        return (pixels > 0) ? m_seconds * 1e9 / pixels : 0;
+    }
+};
+
+/**
+ * @brief last element of benchmarked pipelines : records latency of each frame since its capture
+ * (or since its push for queue cases).
+ */
+class LatencySinkElement: public BaseElement
+{
+public:
     void process(shared_ptr<VideoFrame> videoFrame) override
     {
-        start();
-        pushNewVideoFrame(videoFrame);
+        const double latency = chrono::duration<double, micro>(FrameClock::now() - videoFrame->m_captureTimestamp).count();
+        lock_guard<mutex> lock(m_lock);
+        m_latencies.push_back(latency);
     }
 
     /**
-     * @brief overloaded nothing to do as pushdown stream will be
-     * managed asynchronously by reading from queue in separate
-     * thread.
-     * @param videoFrame(in): shared pointer of video frame.
-     * @return void.
+     * @brief latencies of received frames.
+     * @return vector<double>: microseconds, in order of reception.
      */
-    void processAndPushDownstream(shared_ptr<VideoFrame> videoFrame) override
+    vector<double> latencies() const
     {
-        (void)videoFrame;
-        return;
+        lock_guard<mutex> lock(m_lock);
+        return m_latencies;
     }
+
 private:
-    bool m_runningState;/**< running state of thread . */
-    bool m_startedState;/**< start state of thread : it differs from running state as we can interrupt
-    started thread for example : to avoid start interrupted thread. */
-    thread m_internalThread;/**< pattern to detect. */
-    queue<shared_ptr<VideoFrame>> m_videoFramesQueue;/**< queue of video frame shared pointers. */
-    mutex m_queueLock;/**< mutex to protect wakeup condition. */
-    condition_variable m_queueCv;/**< conditional variable to wakeup read from queue. */
-    uint8_t m_queueMaxSize;/**< max queue size. */
+    mutable mutex m_lock; /**< protects latencies (frames may come from several threads). */
+    vector<double> m_latencies; /**< latencies of received frames. */
+};
 
+/**
+ * @brief discards stdout (frames printed by DisplayElement) while a benchmarked pipeline runs.
+ */
+class StdoutSilencer
+{
+public:
+    StdoutSilencer() : m_previous(cout.rdbuf(&m_discard))
+    {
+    }
+    ~StdoutSilencer()
+    {
+        cout.rdbuf(m_previous);
+    }
+
+private:
     /**
-     * @brief starts asynchronous queue thread if not started.
-     * @param videoFrame(in): shared pointer of video frame.
+     * @brief stream buffer accepting and dropping any character.
      */
-    void start()
+    struct DiscardBuffer: public streambuf
     {
-        if (!m_startedState)
+        int overflow(int c) override
         {
-            m_startedState = true;
-            m_runningState = true;
-            m_internalThread = thread{&AsynchronousQueue::waitForNewVideoFrame, this };
+            return traits_type::not_eof(c);
+        }
+        streamsize xsputn(const char *, streamsize count) override
+        {
+            return count;
         }
+    };
+
+    DiscardBuffer m_discard; /**< buffer of stdout while silenced. */
+    streambuf *m_previous; /**< buffer of stdout restored at destruction. */
+};
+
+/**
+ * @brief benchmarks of hot paths across frame and pattern sizes : frames generation, pattern
+ * detection, asynchronous queue handoff and pipelines of main (DISPLAY_WITH_DETECTOR and default
+ * topology). each case runs for a time budget (and a minimum number of frames) after warm up.
+ */
+class BenchmarkSuite
+{
+public:
+    /**
+     * @brief BenchmarkSuite constructor.
+     * @param quick(in): small frames and short time budget (smoke run).
+     * @param filter(in): only cases whose "name variant" contains filter are run, empty for all cases.
+     */
+    BenchmarkSuite(bool quick, const string &filter) :
+            m_quick(quick), m_filter(filter),
+            m_budget(chrono::duration_cast<FrameClock::duration>(chrono::duration<double>(quick ? 0.05 : 0.5))),
+            m_minFrames(quick ? 5 : 20)
+    {
     }
 
     /**
-     * @brief checks queue size and deletes oldest frames when
-     * size of queue exceeds maxSize specified in input.
-     * @param maxSize(in): max authorize size of async queue.
+     * @brief runs all selected cases.
      */
-    void checkQueueSizeConstraint(uint8_t maxSize)
+    void run()
     {
-        while (m_videoFramesQueue.size() > maxSize)
+        const vector<pair<uint32_t, uint32_t>> frameSizes = m_quick ? vector<pair<uint32_t, uint32_t>>{{320, 240}} :
+                                                            vector<pair<uint32_t, uint32_t>>{{320, 240}, {1280, 720}, {1920, 1080}};
+        const vector<vector<vector<uint8_t>>> patterns
+        {
+            {{0, 1, 0}, {1, 1, 1}, {0, 1, 0}, {1, 0, 1}}, // pattern of main
+            randomPattern(8, 8),
+            randomPattern(16, 16),
+            randomPattern(32, 96)                         // wider than 64 columns : byte comparison
+        };
+
+        for (const auto &size : frameSizes)
+            for (const auto format : {PixelFormat::Gray8, PixelFormat::Mono1})
+            {
+                benchmarkGenerate(size.first, size.second, format, false);
+                benchmarkGenerate(size.first, size.second, format, true);
+                benchmarkMappedFile(size.first, size.second, format);
+            }
+
+        for (const auto &size : frameSizes)
+            for (const auto &pattern : patterns)
+                for (const auto format : {PixelFormat::Gray8, PixelFormat::Mono1})
+                    benchmarkDetection(size.first, size.second, pattern, format);
+
+        for (const auto &size : frameSizes)
+            for (const auto mode : {DetectionMode::FirstMatch, DetectionMode::CountOnly, DetectionMode::TopK})
+                benchmarkDetection(size.first, size.second, patterns[0], PixelFormat::Gray8, mode);
+
+        for (const auto mode : {QueueMode::Locked, QueueMode::Spsc})
+            benchmarkQueue(640, 480, mode);
+
+        const vector<pair<uint32_t, uint32_t>> pipelineSizes = m_quick ? vector<pair<uint32_t, uint32_t>>{{20, 25}} :
+                                                               vector<pair<uint32_t, uint32_t>>{{20, 25}, {320, 240}, {1280, 720}};
+        for (const auto &size : pipelineSizes)
         {
-            auto newVideoFrame = m_videoFramesQueue.front();//get oldest elemet from queue
-            m_videoFramesQueue.pop(); //remove element from queue
-            newVideoFrame.reset(); //free memory hold by shared pointer
+            benchmarkPipeline(size.first, size.second, patterns[0], false);
+            benchmarkPipeline(size.first, size.second, patterns[0], true);
         }
+
+        for (const bool useExecutor : {true, false})
+            for (const auto mode : {StopMode::Drain, StopMode::Discard})
+                benchmarkLifecycle(320, 240, useExecutor, mode);
     }
 
     /**
-     * @brief adds new frame in queue (at the end of queue).
-     * it starts by checking queue size then push new frame
-     * and then wakeup queue read to forward new frame
-     * for next elements to process.
-     * @param newVideoFrame(in): shared pointer of video frame.
+     * @brief results of run cases.
+     * @return vector<BenchmarkResult>: results in run order.
      */
-    void pushNewVideoFrame(shared_ptr<VideoFrame> newVideoFrame)
+    const vector<BenchmarkResult>& results() const
     {
-        if (m_queueMaxSize > 0)
+        return m_results;
+    }
+
+    /**
+     * @brief writes results as a table.
+     * @param out(in/out): output stream.
+     */
+    void printTable(ostream &out) const
+    {
+        out << "kernels : " << SimdKernels::levelName(SimdKernels::active().m_level) << "\n";
+        out << left << setw(10) << "name" << setw(34) << "variant" << setw(11) << "frame" << setw(9) << "pattern"
+            << right << setw(12) << "frames/s" << setw(11) << "ns/pixel" << setw(11) << "p50 us" << setw(11) << "p99 us" << "\n";
+        for (const auto &result : m_results)
         {
-            unique_lock<mutex> lock(m_queueLock);
-            checkQueueSizeConstraint(m_queueMaxSize);
-            m_videoFramesQueue.push(newVideoFrame);
-            lock.unlock();
-            m_queueCv.notify_one();
+            out << left << setw(10) << result.m_name << setw(34) << result.m_variant
+                << setw(11) << (to_string(result.m_width) + "x" + to_string(result.m_height))
+                << setw(9) << (result.m_patternRows ? to_string(result.m_patternRows) + "x" + to_string(result.m_patternColumns) : string("-"))
+                << right << fixed << setprecision(1) << setw(12) << result.framesPerSecond()
+                << setprecision(3) << setw(11) << result.nanosecondsPerPixel()
+                << setprecision(1) << setw(11) << result.m_p50Microseconds << setw(11) << result.m_p99Microseconds << "\n";
         }
+        out.unsetf(ios_base::floatfield);
     }
 
     /**
-     * @brief method executed in thread of asynchronous queue.
-     * it reads from the head of queue and forward for processing
-     * to next element and then sleep waiting for new frames.
+     * @brief writes results as JSON document, to track regressions between releases.
+     * @param out(in/out): output stream.
      */
-    void waitForNewVideoFrame(void)
+    void writeJson(ostream &out) const
     {
-        unique_lock<mutex> lock(m_queueLock);
+        out << "{\n  \"kernels\": \"" << SimdKernels::levelName(SimdKernels::active().m_level) << "\",\n"
+            << "  \"quick\": " << (m_quick ? "true" : "false") << ",\n  \"results\": [";
+        for (size_t i = 0; i < m_results.size(); i++)
+        {
+            const auto &result = m_results[i];
+            out << (i ? ",\n" : "\n") << "    {\"name\": \"" << result.m_name << "\", \"variant\": \"" << result.m_variant
+                << "\", \"width\": " << result.m_width << ", \"height\": " << result.m_height
+                << ", \"pattern_rows\": " << result.m_patternRows << ", \"pattern_columns\": " << result.m_patternColumns
+                << ", \"frames\": " << result.m_frames << ", \"seconds\": " << result.m_seconds
+                << ", \"frames_per_second\": " << result.framesPerSecond() << ", \"ns_per_pixel\": " << result.nanosecondsPerPixel()
+                << ", \"p50_us\": " << result.m_p50Microseconds << ", \"p99_us\": " << result.m_p99Microseconds << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+private:
+    static constexpr uint64_t kSeed = 42; /**< seed of generated frames and patterns. */
+    static constexpr size_t kWarmupFrames = 3; /**< frames run before measures. */
+    static constexpr size_t kDetectionFrames = 8; /**< distinct frames searched in turn by detection cases. */
+    static constexpr size_t kDetectionTopK = 8; /**< matches searched by top-k detection cases. */
+
+    /**
+     * @brief checks if a case is selected by filter.
+     * @param name(in): name of case.
+     * @param variant(in): variant of case.
+     * @return bool: true if case must be run.
+     */
+    bool selected(const string &name, const string &variant) const
+    {
+        return m_filter.empty() || ((name + " " + variant).find(m_filter) != string::npos);
+    }
+
+    /**
+     * @brief random binary pattern.
+     * @param rows(in): pattern rows.
+     * @param columns(in): pattern columns.
+     * @return vector<vector<uint8_t>>: pattern.
+     */
+    static vector<vector<uint8_t>> randomPattern(size_t rows, size_t columns)
+    {
+        Xoshiro256StarStar generator(kSeed + rows * 1000 + columns);
+        vector<vector<uint8_t>> pattern(rows, vector<uint8_t>(columns));
+        for (auto &row : pattern)
+            for (auto &pixel : row)
+                pixel = generator() & 1;
+        return pattern;
+    }
+
+    /**
+     * @brief name of pixels format in variants.
+     * @param format(in): pixels format.
+     * @return const char*: name.
+     */
+    static const char* formatName(PixelFormat format)
+    {
+        return (format == PixelFormat::Mono1) ? "mono1" : "gray8";
+    }
+
+    /**
+     * @brief nearest rank percentile.
+     * @param sorted(in): sorted values, non empty.
+     * @param fraction(in): percentile in ]0, 1].
+     * @return double: value.
+     */
+    static double percentile(const vector<double> &sorted, double fraction)
+    {
+        const size_t rank = static_cast<size_t>(ceil(fraction * sorted.size()));
+        return sorted[min(sorted.size(), max<size_t>(rank, 1)) - 1];
+    }
+
+    /**
+     * @brief stores result of a case.
+     * @param name(in): name of case.
+     * @param variant(in): variant of case.
+     * @param width(in): width of frames.
+     * @param height(in): height of frames.
+     * @param pattern(in): searched pattern, null without detection.
+     * @param elapsed(in): wall time of measured frames.
+     * @param latencies(in): latencies of measured frames in microseconds.
+     */
+    void addResult(const string &name, const string &variant, uint32_t width, uint32_t height, const vector<vector<uint8_t>> *pattern,
+                   FrameClock::duration elapsed, vector<double> latencies)
+    {
+        sort(latencies.begin(), latencies.end());
+        m_results.push_back(BenchmarkResult{name, variant, width, height, pattern ? pattern->size() : 0, pattern ? (*pattern)[0].size() : 0,
+                                            latencies.size(), chrono::duration<double>(elapsed).count(),
+                                            latencies.empty() ? 0 : percentile(latencies, 0.5),
+                                            latencies.empty() ? 0 : percentile(latencies, 0.99)});
+    }
 
-        do
+    /**
+     * @brief runs iteration (one frame) after warm up until time budget and minimum frames are reached,
+     * latency of a frame is duration of its iteration.
+     * @param iteration(in): processing of one frame.
+     * @param elapsed(out): wall time of measured iterations.
+     * @return vector<double>: latencies in microseconds.
+     */
+    vector<double> measure(const function<void()> &iteration, FrameClock::duration &elapsed) const
+    {
+        for (size_t i = 0; i < kWarmupFrames; i++)
+            iteration();
+        vector<double> latencies;
+        const auto start = FrameClock::now();
+        auto now = start;
+        while ((latencies.size() < m_minFrames) || (now - start < m_budget))
         {
-            //Wait until new frame video added notified.
-            m_queueCv.wait(lock, [this]
-            {
-                return (m_videoFramesQueue.size());
-            });
+            iteration();
+            const auto end = FrameClock::now();
+            latencies.push_back(chrono::duration<double, micro>(end - now).count());
+            now = end;
+        }
+        elapsed = now - start;
+        return latencies;
+    }
 
-            //after wait, we own the lock
-            while(m_videoFramesQueue.size())
-            {
-                auto newVideoFrame = m_videoFramesQueue.front(); //get oldest elemet from queue
-                m_videoFramesQueue.pop();//remove element from queue
+    /**
+     * @brief waits until all frames pushed in queue are forwarded or dropped.
+     * @param queue(in): asynchronous queue.
+     */
+    static void waitDrained(const AsynchronousQueue &queue)
+    {
+        for (;;)
+        {
+            const QueueStats stats = queue.stats();
+            if ((stats.m_depth == 0) && (stats.m_delivered + stats.m_droppedOldest >= stats.m_accepted))
+                return;
+            this_thread::sleep_for(chrono::microseconds(50));
+        }
+    }
 
-                //unlock now as we already got a video frame from queue to process
-                lock.unlock();
+    /**
+     * @brief VideoSourceElement::GenerateVideoFrame : frame acquisition and pixels generation.
+     * @param width(in): width of frames.
+     * @param height(in): height of frames.
+     * @param format(in): pixels format.
+     * @param movingObjects(in): MovingObjectsFrameGenerator instead of NoiseFrameGenerator.
+     */
+    void benchmarkGenerate(uint32_t width, uint32_t height, PixelFormat format, bool movingObjects)
+    {
+        const string variant = string(movingObjects ? "moving objects " : "noise ") + formatName(format);
+        if (!selected("generate", variant))
+            return;
+        VideoSourceElement source(width, height, VideoSourceElement::kUnthrottled);
+        if (movingObjects)
+        {
+            MotionSceneConfig scene;
+            scene.m_seed = kSeed;
+            scene.m_objectCount = 8;
+            scene.m_shapes = {{{0, 1, 0}, {1, 1, 1}, {0, 1, 0}, {1, 0, 1}}};
+            source.setFrameGenerator(make_unique<MovingObjectsFrameGenerator>(scene));
+        }
+        else
+        {
+            source.setFrameGenerator(make_unique<NoiseFrameGenerator>(kSeed));
+        }
+        source.setPixelFormat(format);
+        FrameClock::duration elapsed{};
+        auto latencies = measure([&source] { source.GenerateVideoFrame(); }, elapsed);
+        addResult("generate", variant, width, height, nullptr, elapsed, move(latencies));
+    }
 
-                if (!m_runningState)
-                    break;
+    /**
+     * @brief VideoSourceElement::GenerateVideoFrame replaying a raw frames file (MappedFileFrameGenerator,
+     * views of mapping for Gray8 frames, conversion for Mono1 frames).
+     * @param width(in): width of frames.
+     * @param height(in): height of frames.
+     * @param format(in): pixels format.
+     */
+    void benchmarkMappedFile(uint32_t width, uint32_t height, PixelFormat format)
+    {
+        const string variant = string("mapped file ") + formatName(format);
+        if (!selected("generate", variant))
+            return;
+        char path[] = "/tmp/motiondetector_bench_XXXXXX";
+        const int fd = mkstemp(path);
+        if (fd < 0)
+            throw invalid_argument(string("cannot create raw frames file : ") + strerror(errno));
+        NoiseFrameGenerator generator(kSeed);
+        VideoFrame frame(width, height);
+        bool written = true;
+        for (size_t i = 0; i < kDetectionFrames; i++)
+        {
+            generator.generate(frame);
+            for (size_t y = 0; y < height; y++)
+                written = written && (write(fd, frame.row(y).data(), width) == ssize_t(width));
+        }
+        close(fd);
+        try
+        {
+            if (!written)
+                throw invalid_argument(string("cannot write raw frames file ") + path);
+            VideoSourceElement source(width, height, VideoSourceElement::kUnthrottled);
+            source.setFrameGenerator(make_unique<MappedFileFrameGenerator>(path, width, height, true));
+            source.setPixelFormat(format);
+            FrameClock::duration elapsed{};
+            auto latencies = measure([&source] { source.GenerateVideoFrame(); }, elapsed);
+            addResult("generate", variant, width, height, nullptr, elapsed, move(latencies));
+        } catch (...)
+        {
+            unlink(path);
+            throw;
+        }
+        unlink(path);
+    }
 
-                // to notify next elements
-                for_each(m_nextElements.cbegin(), m_nextElements.cend(), [&newVideoFrame](const auto &element)
-                {
-                    element->process(newVideoFrame); element->processAndPushDownstream(newVideoFrame);
-                });
+    /**
+     * @brief DetectorElement::process (checkPatternAndMarkExistingPatterns) on noise frames searched in turn.
+     * @param width(in): width of frames.
+     * @param height(in): height of frames.
+     * @param pattern(in): searched pattern.
+     * @param format(in): pixels format.
+     * @param mode(in): detection mode (TopK one searches kDetectionTopK matches).
+     */
+    void benchmarkDetection(uint32_t width, uint32_t height, const vector<vector<uint8_t>> &pattern, PixelFormat format,
+                            DetectionMode mode = DetectionMode::All)
+    {
+        DetectorConfig config;
+        config.m_detectionMode = mode;
+        config.m_maxMatches = kDetectionTopK;
+        DetectorElement detector(pattern, config);
+        static const char *const modeNames[] = {"", " first", " count", " top-k"};
+        const string variant = detector.matcher().name() + " " + formatName(format) + modeNames[static_cast<int>(mode)];
+        if (!selected("detect", variant))
+            return;
+        NoiseFrameGenerator generator(kSeed);
+        vector<shared_ptr<VideoFrame>> frames;
+        for (size_t i = 0; i < kDetectionFrames; i++)
+        {
+            frames.push_back(make_shared<VideoFrame>(width, height, format));
+            frames.back()->m_sequenceNumber = i;
+            generator.generate(*frames.back());
+        }
+        size_t next = 0;
+        FrameClock::duration elapsed{};
+        auto latencies = measure([&] {
+            const auto &frame = frames[next++ % frames.size()];
+            frame->m_overlay.clear();
+            detector.process(frame);
+        }, elapsed);
+        addResult("detect", variant, width, height, &pattern, elapsed, move(latencies));
+    }
 
-                lock.lock();
-            }
-        } while (m_runningState);
+    /**
+     * @brief AsynchronousQueue handoff : frames pushed by calling thread (blocked when queue is full,
+     * no frame dropped) and forwarded to a sink, latency is time from push to sink.
+     * @param width(in): width of frames.
+     * @param height(in): height of frames.
+     * @param mode(in): queue mode (Locked queue is drained on executor, Spsc one by its thread).
+     */
+    void benchmarkQueue(uint32_t width, uint32_t height, QueueMode mode)
+    {
+        const string variant = (mode == QueueMode::Spsc) ? "spsc ring buffer thread" : "locked executor";
+        if (!selected("queue", variant))
+            return;
+        PipelineExecutor executor(1);
+        LatencySinkElement sink;
+        FramePool framePool(width, height, 64);
+        AsynchronousQueueConfig config;
+        config.m_maxSize = 8;
+        config.m_mode = mode;
+        config.m_policy = BackpressurePolicy::BlockProducer;
+        if (mode == QueueMode::Locked)
+            config.m_executor = &executor;
+        AsynchronousQueue queue(config);
+        queue.link(&sink);
+
+        const auto push = [&queue, &framePool] {
+            auto frame = framePool.acquire();
+            frame->m_captureTimestamp = FrameClock::now();
+            queue.process(frame);
+        };
+        for (size_t i = 0; i < kWarmupFrames; i++)
+            push();
+        waitDrained(queue);
+        const size_t warmupFrames = sink.latencies().size();
+        const auto start = FrameClock::now();
+        for (size_t frames = 0; (frames < m_minFrames) || (FrameClock::now() - start < m_budget); frames++)
+            push();
+        waitDrained(queue);
+        const auto elapsed = FrameClock::now() - start;
+        auto latencies = sink.latencies();
+        latencies.erase(latencies.begin(), latencies.begin() + warmupFrames);
+        addResult("queue", variant, width, height, nullptr, elapsed, move(latencies));
+    }
+
+    /**
+     * @brief pipelines of main driven by an unthrottled source : DISPLAY_WITH_DETECTOR topology (source,
+     * detector and display in calling thread) or default topology (display in calling thread, detector
+     * behind a one frame asynchronous queue on executor, late frames are dropped). frames, throughput and
+     * latency (from capture to end of processing by all elements after source, or by detector in default
+     * topology) are the ones of frames reaching detector.
+     * @param width(in): width of frames.
+     * @param height(in): height of frames.
+     * @param pattern(in): searched pattern.
+     * @param asynchronous(in): default topology instead of DISPLAY_WITH_DETECTOR one.
+     */
+    void benchmarkPipeline(uint32_t width, uint32_t height, const vector<vector<uint8_t>> &pattern, bool asynchronous)
+    {
+        const string variant = asynchronous ? "default" : "display with detector";
+        if (!selected("pipeline", variant))
+            return;
+        PipelineExecutor executor;
+        LatencySinkElement sink;
+        DetectorElement detector(pattern);
+        DisplayElement display;
+        AsynchronousQueueConfig config;
+        config.m_maxSize = 1;
+        config.m_executor = &executor;
+        AsynchronousQueue queue(config);
+        VideoSourceElement source(width, height, VideoSourceElement::kUnthrottled);
+        source.setFrameGenerator(make_unique<NoiseFrameGenerator>(kSeed));
+        if (asynchronous)
+        {
+            source.link(&queue)->link(&detector)->link(&sink);
+            source.link(&display);
+        }
+        else
+        {
+            source.link(&detector)->link(&display);
+            detector.link(&sink);
+        }
+
+        StdoutSilencer silencer;
+        const auto push = [&source] { source.processAndPushDownstream(source.GenerateVideoFrame()); };
+        for (size_t i = 0; i < kWarmupFrames; i++)
+            push();
+        waitDrained(queue);
+        const size_t warmupFrames = sink.latencies().size();
+        const auto start = FrameClock::now();
+        for (size_t frames = 0; (frames < m_minFrames) || (FrameClock::now() - start < m_budget); frames++)
+            push();
+        waitDrained(queue);
+        const auto elapsed = FrameClock::now() - start;
+        auto latencies = sink.latencies();
+        latencies.erase(latencies.begin(), latencies.begin() + warmupFrames);
+        addResult("pipeline", variant, width, height, &pattern, elapsed, move(latencies));
+    }
+
+    /**
+     * @brief restarts of an async-detector pipeline built by PipelineBuilder with a throttled source
+     * (30 fps) : startup latency is time from Pipeline::launch to first frame reaching detector,
+     * shutdown latency is duration of Pipeline::stop. frames of results are restarts.
+     * @param width(in): width of frames.
+     * @param height(in): height of frames.
+     * @param useExecutor(in): source and queue on executor instead of dedicated threads.
+     * @param mode(in): stop mode of queue.
+     */
+    void benchmarkLifecycle(uint32_t width, uint32_t height, bool useExecutor, StopMode mode)
+    {
+        const string threads = useExecutor ? "executor" : "dedicated";
+        const string stopVariant = string(mode == StopMode::Drain ? "stop drain " : "stop discard ") + threads;
+        // startup does not depend on stop mode
+        const bool measureStart = (mode == StopMode::Drain) && selected("lifecycle", "start " + threads);
+        if (!measureStart && !selected("lifecycle", stopVariant))
+            return;
+        PipelineConfig config;
+        config.m_topology = PipelineTopology::AsyncDetector;
+        config.m_width = width;
+        config.m_height = height;
+        config.m_frameRate = 30;
+        config.m_seed = kSeed;
+        config.m_useExecutor = useExecutor;
+        LatencySinkElement sink;
+        auto pipeline = PipelineBuilder::build(config);
+        pipeline->find("detector")->link(&sink);
+
+        StdoutSilencer silencer;
+        vector<double> startLatencies;
+        vector<double> stopLatencies;
+        const auto start = FrameClock::now();
+        while ((stopLatencies.size() < m_minFrames) || (FrameClock::now() - start < m_budget))
+        {
+            const size_t frames = sink.latencies().size();
+            const auto launch = FrameClock::now();
+            pipeline->launch();
+            while (sink.latencies().size() == frames)
+                this_thread::sleep_for(chrono::microseconds(20));
+            startLatencies.push_back(chrono::duration<double, micro>(FrameClock::now() - launch).count());
+            stopLatencies.push_back(chrono::duration<double, micro>(pipeline->stop(mode)).count());
+        }
+        const auto elapsed = FrameClock::now() - start;
+        if (measureStart)
+            addResult("lifecycle", "start " + threads, width, height, nullptr, elapsed, move(startLatencies));
+        if (selected("lifecycle", stopVariant))
+            addResult("lifecycle", stopVariant, width, height, nullptr, elapsed, move(stopLatencies));
     }
+
+    bool m_quick; /**< small frames and short time budget. */
+    string m_filter; /**< filter of cases. */
+    FrameClock::duration m_budget; /**< min measured time of a case. */
+    size_t m_minFrames; /**< min measured frames of a case. */
+    vector<BenchmarkResult> m_results; /**< results of run cases. */
 };
 
 /**
- * main of process
+ * main of benchmarks.
  */
-int main(int argc,char* argv[])
+int main(int argc, char* argv[])
 {
-    uint8_t width = 20;
-    uint8_t height = 25;
-    uint8_t frameRate = 1;
-    VideoSourceElement *videoSourceElement = nullptr;
-    DisplayElement *displayElement = nullptr;
-    DetectorElement *detectorElement = nullptr;
-    AsynchronousQueue *asynchQueue = nullptr;
-    (void)asynchQueue;
-    (void)detectorElement;
-    
-    vector<vector<uint8_t>> pattern
-    {
-        { 0, 1, 0 }, // { . , + , .}
-        { 1, 1, 1 }, // { + , + , +}
-        { 0, 1, 0 }, // { . , + , .}
-        { 1, 0, 1 }  // { + , . , +}
-    };
+    // options : --quick, --filter=text, --json=file (--json=- writes JSON on stdout instead of table), --log-level=level
+    bool quick = false;
+    string filter;
+    string jsonPath;
+    Logger::setLevel(LogLevel::Quiet);
+    for (int i = 1; i < argc; i++)
+    {
+        const string argument = argv[i];
+        const auto value = [&argument](const string &option) { return argument.substr(option.size()); };
+        try
+        {
+            if (argument == "--quick")
+                quick = true;
+            else if (argument.compare(0, 9, "--filter=") == 0)
+                filter = value("--filter=");
+            else if (argument.compare(0, 7, "--json=") == 0)
+                jsonPath = value("--json=");
+            else if (argument.compare(0, 12, "--log-level=") == 0)
+                Logger::setLevel(Logger::parseLevel(value("--log-level=")));
+            else
+                throw invalid_argument("unknown option " + argument);
+        } catch (const exception &e)
+        {
+            cout << e.what() << "\n";
+            return -1;
+        }
+    }
 
+    BenchmarkSuite suite(quick, filter);
     try
     {
-        videoSourceElement = new VideoSourceElement(width, height, frameRate);
-        displayElement = new DisplayElement();
-#if defined(DISPLAY_ONLY)
-        videoSourceElement->link(displayElement);
-        //    ******************           *******************
-        //    *                *           *                 *
-        //    *  VIDEO SOURCE  ***********>*     DISPLAY     *
-        //    *                *           *                 *
-        //    ******************           *******************
-#elif defined(DISPLAY_WITH_DETECTOR)
-        DetectorElement *detectorElement = new DetectorElement(pattern);
-        videoSourceElement->link(detectorElement)->link(displayElement);
-        //    ******************           *******************           *******************
-        //    *                *           *                 *           *                 *
-        //    *  VIDEO SOURCE  ***********>*     DETECTOR    ***********>*     DISPLAY     *
-        //    *                *           *                 *           *                 *
-        //    ******************           *******************           *******************
-#else //to avoid that detector bloque display we use asynchronous queue for dispatching samples
-        uint8_t asyncQueueMaxSize = 1;
-        DetectorElement *detectorElement = new DetectorElement(pattern);
-        AsynchronousQueue *asynchQueue = new AsynchronousQueue(asyncQueueMaxSize);
+        suite.run();
+    } catch (const exception &e)
+    {
+        cout << "Unexpected exception: " << e.what() << "\n";
+        return -1;
+    }
 
-        //    ******************           *******************           *******************
-        //    *                *           *                 *           *                 *
-        //    *  VIDEO SOURCE  ***********>*   AsyncQueue    ***********>*     DETECTOR    *
-        //    *                *     *     *                 *           *                 *
-        //    ******************     *     *******************           *******************
-        //                           *
-        //                           *     *******************
-        //                           *     *                 *
-        //                           *****>*   DISPLAY       *
-        //                                 *                 *
-        //                                 *******************
+    if (jsonPath == "-")
+    {
+        suite.writeJson(cout);
+        return 0;
+    }
+    suite.printTable(cout);
+    if (!jsonPath.empty())
+    {
+        ofstream json(jsonPath);
+        suite.writeJson(json);
+        if (!json)
+        {
+            cout << "cannot write " << jsonPath << "\n";
+            return -1;
+        }
+    }
+    return 0;
+}
+#else
+/**
+ * main of process
+ */
+int main(int argc,char* argv[])
+{
+    // pipeline topology and parameters are read from options (see PipelineBuilder::usage)
+    PipelineConfig config;
+    const vector<string> arguments(argv + 1, argv + argc);
+    if (find(arguments.begin(), arguments.end(), "--help") != arguments.end())
+    {
+        cout << PipelineBuilder::usage();
+        return 0;
+    }
+    try
+    {
+        PipelineBuilder::parseArguments(arguments, config);
+    } catch (const exception &e)
+    {
+        cout << e.what() << "\n" << PipelineBuilder::usage();
+        return -1;
+    }
+    Logger::setLevel(config.m_logLevel);
 
-        videoSourceElement->link(asynchQueue)->link(detectorElement);
-        videoSourceElement->link(displayElement);
-#endif
-        videoSourceElement->start();
+    try
+    {
+        SignalStopper::blockSignals();
+        unique_ptr<Pipeline> pipeline = PipelineBuilder::build(config);
+        if (config.m_statsInterval > 0)
+            pipeline->statsReporter().start(chrono::duration_cast<FrameClock::duration>(chrono::duration<double>(config.m_statsInterval)));
+        SignalStopper stopper(*pipeline, config.m_stopMode);
+        pipeline->start();
 
     } catch (const exception &e)
     {
-        cout << "Unexpected exception: %s" << e.what();
+        cout << "Unexpected exception: " << e.what() << "\n";
         return -1;
     } catch (...)
     {
@@ -635,10 +8519,6 @@ int main(int argc,char* argv[])
         return -1;
     }
 
-    delete videoSourceElement;
-    delete displayElement;
-    delete asynchQueue;
-    delete detectorElement;
-
     return 0;
 }
+#endif